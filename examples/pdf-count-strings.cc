@@ -1,7 +1,8 @@
 //
-// This example illustrates the use of QPDFObjectHandle::TokenFilter with filterContents. See also
-// pdf-filter-tokens.cc for an example that uses QPDFObjectHandle::TokenFilter with
-// addContentTokenFilter.
+// This example illustrates the use of QPDFObjectHandle::TokenViewFilter with filterContents. A
+// TokenViewFilter is a TokenFilter that is passed views of the tokenizer's buffers instead of
+// copies, which is faster for filters that don't need to keep tokens. See also pdf-filter-tokens.cc
+// for an example that uses QPDFObjectHandle::TokenFilter with addContentTokenFilter.
 //
 
 #include <cstdlib>
@@ -23,12 +24,12 @@ usage()
     exit(2);
 }
 
-class StringCounter: public QPDFObjectHandle::TokenFilter
+class StringCounter: public QPDFObjectHandle::TokenViewFilter
 {
   public:
     StringCounter() = default;
     ~StringCounter() override = default;
-    void handleToken(QPDFTokenizer::Token const&) override;
+    void handleToken(QPDFTokenizer::TokenView const&) override;
     void handleEOF() override;
     int getCount() const;
 
@@ -37,7 +38,7 @@ class StringCounter: public QPDFObjectHandle::TokenFilter
 };
 
 void
-StringCounter::handleToken(QPDFTokenizer::Token const& token)
+StringCounter::handleToken(QPDFTokenizer::TokenView const& token)
 {
     // Count string tokens
     if (token.getType() == QPDFTokenizer::tt_string) {
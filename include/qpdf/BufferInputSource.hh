@@ -23,6 +23,8 @@
 #include <qpdf/Buffer.hh>
 #include <qpdf/InputSource.hh>
 
+#include <string_view>
+
 class QPDF_DLL_CLASS BufferInputSource: public InputSource
 {
   public:
@@ -51,6 +53,10 @@ class QPDF_DLL_CLASS BufferInputSource: public InputSource
     QPDF_DLL
     void unreadCh(char ch) override;
 
+    // Return the contents of the buffer.
+    QPDF_DLL
+    std::string_view view() const;
+
   private:
     bool own_memory;
     std::string description;
@@ -26,6 +26,7 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <string_view>
 
 // Remember to use QPDF_DLL_CLASS on anything derived from InputSource so it will work with
 // dynamic_cast across the shared object boundary.
@@ -81,8 +82,8 @@ class QPDF_DLL_CLASS InputSource
     size_t read_line(std::string& str, size_t count, qpdf_offset_t at = -1);
     std::string read_line(size_t count, qpdf_offset_t at = -1);
     inline qpdf_offset_t fastTell();
-    inline bool fastRead(char&);
-    inline void fastUnread(bool);
+    inline std::string_view fastWindow();
+    inline void fastAdvance(size_t);
     inline void loadBuffer();
 
   protected:
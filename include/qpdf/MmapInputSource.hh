@@ -0,0 +1,71 @@
+// Copyright (c) 2005-2021 Jay Berkenbilt
+// Copyright (c) 2022-2025 Jay Berkenbilt and Manfred Holger
+//
+// This file is part of qpdf.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied. See the License for the specific language governing permissions and limitations under
+// the License.
+//
+// Versions of qpdf prior to version 7 were released under the terms of version 2.0 of the Artistic
+// License. At your option, you may continue to consider qpdf to be licensed under those terms.
+// Please see the manual for additional information.
+
+#ifndef QPDF_MMAPINPUTSOURCE_HH
+#define QPDF_MMAPINPUTSOURCE_HH
+
+#include <qpdf/InputSource.hh>
+
+#include <string_view>
+
+// An InputSource that maps an entire file into memory. Reading from it never requires a system
+// call, and qpdf operates directly on the mapped data where it can, such as when tokenizing,
+// searching, or reading stream data. On systems that don't support memory-mapped files, or if the
+// file can't be mapped, the whole file is read into memory instead. The file must not be modified
+// while the input source exists.
+class QPDF_DLL_CLASS MmapInputSource final: public InputSource
+{
+  public:
+    QPDF_DLL
+    MmapInputSource(char const* filename);
+
+    MmapInputSource(MmapInputSource const&) = delete;
+    MmapInputSource& operator=(MmapInputSource const&) = delete;
+
+    QPDF_DLL
+    ~MmapInputSource() final;
+    QPDF_DLL
+    qpdf_offset_t findAndSkipNextEOL() final;
+    QPDF_DLL
+    std::string const& getName() const final;
+    QPDF_DLL
+    qpdf_offset_t tell() final;
+    QPDF_DLL
+    void seek(qpdf_offset_t offset, int whence) final;
+    QPDF_DLL
+    void rewind() final;
+    QPDF_DLL
+    size_t read(char* buffer, size_t length) final;
+    QPDF_DLL
+    void unreadCh(char ch) final;
+
+    // Return the entire contents of the file.
+    QPDF_DLL
+    std::string_view view() const;
+
+  private:
+    std::string filename;
+    char const* data{nullptr};
+    size_t size{0};
+    bool mapped{false};
+    std::string contents;
+    qpdf_offset_t cur_offset{0};
+};
+
+#endif // QPDF_MMAPINPUTSOURCE_HH
@@ -73,6 +73,33 @@ class QPDF_DLL_CLASS Pl_DCT: public Pipeline
         J_COLOR_SPACE color_space,
         CompressConfig* config_callback = nullptr);
 
+    // Chroma subsampling for compressing color images. s_default leaves the choice to libjpeg,
+    // which uses s_420.
+    enum subsampling_e { s_default, s_444, s_422, s_420 };
+
+    // The following options apply when compressing and must be set before finish is called. Any
+    // CompressConfig is applied after them and may override them.
+
+    // Set the JPEG quality, from 1 (smallest) to 100 (best). If not set, libjpeg's default of 75
+    // is used.
+    QPDF_DLL
+    void setQuality(int quality);
+
+    // Set the chroma subsampling. This only affects images whose color space is JCS_RGB, which
+    // are stored as YCbCr.
+    QPDF_DLL
+    void setSubsampling(subsampling_e);
+
+    // Compute Huffman tables for the image rather than using the standard tables. This makes
+    // the output smaller at the cost of an extra pass over the image data.
+    QPDF_DLL
+    void setOptimizeHuffman(bool);
+
+    // Write a progressive rather than a baseline JPEG. Progressive JPEGs are usually a little
+    // smaller and always use optimized Huffman tables, but they are slower to write and to read.
+    QPDF_DLL
+    void setProgressive(bool);
+
     QPDF_DLL
     ~Pl_DCT() override;
 
@@ -29,6 +29,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -182,6 +183,29 @@ class QPDF
     QPDF_DLL
     void setPasswordIsHexKey(bool);
 
+    // Call this before calling any of the process methods to give additional passwords to try if
+    // the password passed to the process method doesn't work. The encryption dictionary is read
+    // once, and the passwords are tried in order; the first one that matches is used as if it had
+    // been passed to the process method. For files encrypted with 256-bit keys (R5 and R6), whose
+    // passwords are expensive to check, the candidates may be checked on multiple threads; see
+    // setPasswordCandidateJobs. If no password works, the process method throws the same exception
+    // as for a single incorrect password. Candidates are ignored for files that are not encrypted
+    // and when the password is a hex key.
+    QPDF_DLL
+    void setPasswordCandidates(std::vector<std::string> const& passwords);
+
+    // If jobs is greater than 1, check the password candidates given with setPasswordCandidates for
+    // files encrypted with 256-bit keys using jobs threads. The result is the same as checking them
+    // one at a time. A value of 0 means one thread per available CPU. The default is 1.
+    QPDF_DLL
+    void setPasswordCandidateJobs(int jobs);
+
+    // Return the password with which an encrypted file was opened. This is the password that was
+    // passed to the process method or, if it didn't work, the candidate from setPasswordCandidates
+    // that did.
+    QPDF_DLL
+    std::string const& getMatchedPassword() const;
+
     // Create a QPDF object for an empty PDF.  This PDF has no pages or objects other than a minimal
     // trailer, a document catalog, and a /Pages tree containing zero pages.  Pages and other
     // objects can be added to the file in the normal way, and the trailer and document catalog can
@@ -229,6 +253,25 @@ class QPDF
     QPDF_DLL
     void setIgnoreXRefStreams(bool);
 
+    // If true, processFile(char const* filename, ...) reads the file through a MmapInputSource
+    // rather than a FileInputSource. The file is mapped into memory, and tokenizing, searching, and
+    // reading stream data operate directly on the mapped data. This can be considerably faster for
+    // large files. The file must not be modified while the QPDF object is in use. This has no
+    // effect on the other process methods.
+    QPDF_DLL
+    void setMmapInput(bool);
+
+    // If jobs is greater than 1, when an object in an object stream is first resolved, decode that
+    // object stream and the object streams that follow it in order of object number using jobs
+    // threads, reading ahead by up to about 16 MiB of compressed data per thread. Reading the raw
+    // stream data and creating the objects remain on the calling thread; only inflating the data
+    // and reading the object stream headers are done in parallel. Object streams whose decoding
+    // would require anything other than plain /FlateDecode, or that cause warnings, are decoded
+    // as usual when they are needed. A value of 0 means one thread per available CPU. The default
+    // is 1.
+    QPDF_DLL
+    void setObjectStreamJobs(int jobs);
+
     // By default, any warnings are issued to std::cerr or the error stream specified in a call to
     // setOutputStreams as they are encountered.  If this method is called with a true value,
     // reporting of warnings is suppressed.  You may still retrieve warnings by calling getWarnings.
@@ -691,6 +734,21 @@ class QPDF
     QPDF_DLL
     std::vector<QPDFObjectHandle> const& getAllPages();
 
+    // Return the number of pages and the page at position n (numbered from 0) without traversing
+    // the whole pages tree. If getAllPages() has already been called, these just consult its
+    // result. Otherwise, getPageCount() reads /Count from the root of the pages tree, and getPage()
+    // descends from the root using the /Count values of intermediate nodes, so finding a page
+    // takes time proportional to the depth of the tree rather than to the number of pages. Neither
+    // method repairs the pages tree. Instead, if a node on the way is not well-formed (for example,
+    // if its /Count does not match its /Kids, if a page would have to be repaired by getAllPages(),
+    // or if there is a loop), they fall back to calling getAllPages(). Note that the lazy descent
+    // can't detect a page object that appears more than once in the pages tree and will return the
+    // same object for each occurrence. getPage() returns a null object if n is out of range.
+    QPDF_DLL
+    size_t getPageCount();
+    QPDF_DLL
+    QPDFObjectHandle getPage(size_t n);
+
     QPDF_DLL
     bool everCalledGetAllPages() const;
     QPDF_DLL
@@ -755,6 +813,7 @@ class QPDF
     static std::string const qpdf_version;
 
     class ObjCache;
+    class DecodedObjectStream;
     class ObjCopier;
     class EncryptionParameters;
     class ForeignStreamData;
@@ -767,7 +826,7 @@ class QPDF
     void inParse(bool);
     void setTrailer(QPDFObjectHandle obj);
     void read_xref(qpdf_offset_t offset);
-    bool resolveXRefTable();
+    bool resolveXRefTable(bool release = false);
     void reconstruct_xref(QPDFExc& e, bool found_startxref = true);
     bool parse_xrefFirst(std::string const& line, int& obj, int& num, int& bytes);
     bool read_xrefEntry(qpdf_offset_t& f1, int& f2, char& type);
@@ -804,6 +863,14 @@ class QPDF
         bool skip_cache_if_in_xref);
     std::shared_ptr<QPDFObject> const& resolve(QPDFObjGen og);
     void resolveObjectsInStream(int obj_stream_number);
+    void decodeObjectStreams(int obj_stream_number);
+    void readObjectStreamHeader(
+        qpdf::Tokenizer& tokenizer,
+        int obj_stream_number,
+        unsigned int n,
+        int first,
+        DecodedObjectStream& decoded,
+        std::function<void(QPDFExc&&)> const& warn_fn);
     void stopOnError(std::string const& message);
     QPDFObjGen nextObjGen();
     QPDFObjectHandle newIndirect(QPDFObjGen, std::shared_ptr<QPDFObject> const&);
@@ -855,7 +922,10 @@ class QPDF
 
     // For QPDFWriter:
 
-    std::map<QPDFObjGen, QPDFXRefEntry> const& getXRefTableInternal();
+    std::optional<size_t> rawStreamLength(QPDFObjectHandle& stream);
+    char copyRawStreamData(QPDFObjectHandle& stream, Pipeline& pipeline);
+    char copyInputFile(Pipeline& pipeline);
+    std::vector<QPDFObjGen> getModifiedObjects();
     template <typename T>
     void optimize_internal(
         T const& object_stream_data,
@@ -1002,6 +1072,7 @@ class QPDF
         std::map<std::string, std::vector<QPDFObjectHandle>>&,
         bool allow_changes,
         bool warn_skipped_keys);
+    void pushInheritedAttributesToOnePage(QPDFObjectHandle page);
     void updateObjectMaps(
         ObjUser const& ou,
         QPDFObjectHandle oh,
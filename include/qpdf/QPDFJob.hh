@@ -529,6 +529,7 @@ class QPDFJob
         QPDFPageObjectHelper& dest_page);
     void validateUnderOverlay(QPDF& pdf, UnderOverlay* uo);
     void handleTransformations(QPDF& pdf);
+    void optimizeImages(QPDF& pdf);
     void addAttachments(QPDF& pdf);
     void copyAttachments(QPDF& pdf);
 
@@ -560,9 +561,10 @@ class QPDFJob
     void doJSONAcroform(Pipeline* p, bool& first, QPDF& pdf);
     void doJSONEncrypt(Pipeline* p, bool& first, QPDF& pdf);
     void doJSONAttachments(Pipeline* p, bool& first, QPDF& pdf);
-    void addOutlinesToJson(
+    void writeOutlines(
+        Pipeline* p,
         std::vector<QPDFOutlineObjectHelper> outlines,
-        JSON& j,
+        size_t depth,
         std::map<QPDFObjGen, int>& page_numbers);
 
     enum remove_unref_e { re_auto, re_yes, re_no };
@@ -581,6 +583,7 @@ class QPDFJob
         static int constexpr DEFAULT_OI_MIN_WIDTH = 128;
         static int constexpr DEFAULT_OI_MIN_HEIGHT = 128;
         static int constexpr DEFAULT_OI_MIN_AREA = 16384;
+        static size_t constexpr DEFAULT_OI_MAX_MEMORY = 256 * 1024 * 1024;
         static int constexpr DEFAULT_II_MIN_BYTES = 1024;
 
         Members();
@@ -592,10 +595,15 @@ class QPDFJob
         unsigned long encryption_status{0};
         bool verbose{false};
         std::shared_ptr<char> password;
+        std::vector<std::string> password_candidates;
+        int password_candidate_jobs{1};
         bool linearize{false};
+        bool streaming_write{false};
+        bool incremental_update{false};
         bool decrypt{false};
         bool remove_restrictions{false};
         int split_pages{0};
+        int split_pages_jobs{1};
         bool progress{false};
         std::function<void(int)> progress_handler{nullptr};
         bool suppress_warnings{false};
@@ -634,6 +642,7 @@ class QPDFJob
         bool recompress_flate{false};
         bool recompress_flate_set{false};
         int compression_level{-1};
+        int compression_jobs{1};
         qpdf_stream_decode_level_e decode_level{qpdf_dl_generalized};
         bool decode_level_set{false};
         bool normalize_set{false};
@@ -642,6 +651,8 @@ class QPDFJob
         bool object_stream_set{false};
         qpdf_object_stream_e object_stream_mode{qpdf_o_preserve};
         bool ignore_xref_streams{false};
+        bool mmap_input{false};
+        int object_stream_jobs{1};
         bool qdf_mode{false};
         bool preserve_unreferenced_objects{false};
         remove_unref_e remove_unreferenced_page_resources{re_auto};
@@ -700,6 +711,12 @@ class QPDFJob
         size_t oi_min_width{DEFAULT_OI_MIN_WIDTH};
         size_t oi_min_height{DEFAULT_OI_MIN_HEIGHT};
         size_t oi_min_area{DEFAULT_OI_MIN_AREA};
+        size_t oi_max_memory{DEFAULT_OI_MAX_MEMORY};
+        int optimize_images_jobs{1};
+        int jpeg_quality{0};
+        int jpeg_subsampling{0}; // Pl_DCT::subsampling_e
+        bool jpeg_optimize_huffman{false};
+        bool jpeg_progressive{false};
         size_t ii_min_bytes{DEFAULT_II_MIN_BYTES};
         std::vector<UnderOverlay> underlay;
         std::vector<UnderOverlay> overlay;
@@ -190,6 +190,29 @@ class QPDFObjectHandle: public qpdf::BaseHandle
         Pipeline* pipeline;
     };
 
+    // A TokenViewFilter is a TokenFilter whose handleToken method is passed a
+    // QPDFTokenizer::TokenView rather than a QPDFTokenizer::Token. When it is run by
+    // Pl_QPDFTokenizer, which is what happens with addTokenFilter, filterPageContents, and the
+    // other methods that take a TokenFilter, the views refer to the tokenizer's own buffers, so
+    // filtering doesn't create any strings for the tokens. The views are only valid until
+    // handleToken returns. A TokenViewFilter may be used anywhere a TokenFilter may be used. If
+    // it is passed a Token, it is handled through a view of the token. This was introduced in
+    // qpdf 12.1.
+    class QPDF_DLL_CLASS TokenViewFilter: public TokenFilter
+    {
+      public:
+        TokenViewFilter() = default;
+        ~TokenViewFilter() override = default;
+        virtual void handleToken(QPDFTokenizer::TokenView const&) = 0;
+        QPDF_DLL
+        void handleToken(QPDFTokenizer::Token const&) final;
+
+      protected:
+        using TokenFilter::writeToken;
+        QPDF_DLL
+        void writeToken(QPDFTokenizer::TokenView const&);
+    };
+
     // This class is used by parse to decrypt strings when reading an object that contains encrypted
     // strings.
     class StringDecrypter
@@ -60,8 +60,10 @@ class QPDFPageDocumentHelper: public QPDFDocumentHelper
     // Add a new page at the beginning or the end of the current pdf. The newpage parameter may be
     // either a direct object, an indirect object from this QPDF, or an indirect object from another
     // QPDF. If it is a direct object, it will be made indirect. If it is an indirect object from
-    // another QPDF, this method will call pushInheritedAttributesToPage on the other file and then
-    // copy the page to this QPDF using the same underlying code as copyForeignObject. At this
+    // another QPDF, this method will set any attributes the page inherits from its ancestors in the
+    // other file on the page itself, as pushInheritedAttributesToPage would, and then copy the page
+    // to this QPDF using the same underlying code as copyForeignObject. Since qpdf 12.1, this no
+    // longer changes the pages tree of the other file or enumerates its pages. At this
     // stage, if the indirect object is already in the pages tree, a shallow copy is made to avoid
     // adding the same page more than once. In version 10.3.1 and earlier, adding a page that
     // already existed would throw an exception and could cause qpdf to crash on subsequent page
@@ -27,6 +27,7 @@
 #include <cstdio>
 #include <memory>
 #include <string>
+#include <string_view>
 
 namespace qpdf
 {
@@ -130,6 +131,84 @@ class QPDFTokenizer
         std::string error_message;
     };
 
+    // A TokenView holds the same information as a Token, but its values refer to strings owned by
+    // something else, usually the tokenizer, instead of being copies. It is only valid for as long
+    // as those strings are unchanged. Pl_QPDFTokenizer passes TokenViews to
+    // QPDFObjectHandle::TokenViewFilter so that no strings need to be created for each token. This
+    // was introduced in qpdf 12.1.
+    class TokenView
+    {
+      public:
+        TokenView() = default;
+        TokenView(
+            token_type_e type,
+            std::string_view value,
+            std::string_view raw_value,
+            std::string_view error_message = {}) :
+            type(type),
+            value(value),
+            raw_value(raw_value),
+            error_message(error_message)
+        {
+        }
+        // The view is valid for as long as token is.
+        explicit TokenView(Token const& token) :
+            type(token.getType()),
+            value(token.getValue()),
+            raw_value(token.getRawValue()),
+            error_message(token.getErrorMessage())
+        {
+        }
+        token_type_e
+        getType() const
+        {
+            return type;
+        }
+        std::string_view
+        getValue() const
+        {
+            return value;
+        }
+        std::string_view
+        getRawValue() const
+        {
+            return raw_value;
+        }
+        std::string_view
+        getErrorMessage() const
+        {
+            return error_message;
+        }
+        bool
+        isInteger() const
+        {
+            return type == tt_integer;
+        }
+        bool
+        isWord() const
+        {
+            return type == tt_word;
+        }
+        bool
+        isWord(std::string_view word) const
+        {
+            return type == tt_word && value == word;
+        }
+        // Return a Token holding copies of the values.
+        Token
+        toToken() const
+        {
+            return {
+                type, std::string(value), std::string(raw_value), std::string(error_message)};
+        }
+
+      private:
+        token_type_e type{tt_bad};
+        std::string_view value;
+        std::string_view raw_value;
+        std::string_view error_message;
+    };
+
     QPDF_DLL
     QPDFTokenizer();
 
@@ -28,6 +28,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <string_view>
@@ -212,6 +213,16 @@ class QPDFWriter
     QPDF_DLL
     void setRecompressFlate(bool);
 
+    // Compress stream data using up to the given number of threads. If the number is 0, use one
+    // thread per available CPU. The default is 1, which compresses each stream as it is written.
+    // Otherwise, QPDFWriter reads and decodes the data for a window of upcoming streams in the
+    // order in which they will be written, compresses the data of those that need it in parallel,
+    // and then writes them. At most about 16 MiB of uncompressed stream data per thread is held in
+    // memory at once, though a single larger stream is always handled as a whole. The output is
+    // identical to what is written when this is 1.
+    QPDF_DLL
+    void setCompressionJobs(int);
+
     // Set value of content stream normalization.  The default is "false".  If true, we attempt to
     // normalize newlines inside of content streams.  Some constructs such as inline images may
     // thwart our efforts.  There may be some cases where this can damage the content stream.  This
@@ -405,6 +416,35 @@ class QPDFWriter
     QPDF_DLL
     void setLinearizationPass1Filename(std::string const&);
 
+    // Write in streaming mode. This bounds the memory used while writing for very large files. In
+    // streaming mode, each object is written as soon as it is reached, and the memory its value
+    // takes up is released once it has been written. Only the renumbering and cross-reference
+    // information, a small fixed amount per object, is kept until the end of the file. If object
+    // streams are generated, or preserved from an input file that has them, objects are collected
+    // into new object streams of at most 100 objects in the order in which they are written rather
+    // than grouped in advance, which would require reading the whole file first.
+    //
+    // Objects that were read from the input by the writer are read again if they are needed after
+    // they have been written, for example by a stream data provider. Objects that had been read or
+    // created before write() was called are kept in memory. Streaming mode has no effect when
+    // creating linearized output.
+    QPDF_DLL
+    void setStreamingMode(bool);
+
+    // Write an incremental update. The output is the input file of the QPDF, copied byte for byte,
+    // followed by the objects that have been changed or added and a new cross-reference section
+    // whose /Prev entry points to the input's last one. Since the original bytes are kept,
+    // existing digital signatures stay valid. Objects keep their numbers, and objects that have
+    // not been changed are not written. The new cross-reference section is a stream if the input's
+    // last one is.
+    //
+    // The input's encryption, if any, is kept. Linearization, QDF mode, object stream and PDF
+    // version settings are ignored, as are settings that would change encryption. write() throws
+    // std::runtime_error if the QPDF has no input file to which an update can be appended, such as
+    // when its cross-reference table had to be reconstructed.
+    QPDF_DLL
+    void setIncrementalUpdate(bool);
+
     // Create PCLm output. This is only useful for clients that know how to create PCLm files. If a
     // file is structured exactly as PCLm requires, this call will tell QPDFWriter to write the PCLm
     // header, create certain unreferenced streams required by the standard, and write the objects
@@ -486,8 +526,11 @@ class QPDFWriter
     void writePad(size_t nspaces);
     void assignCompressedObjectNumbers(QPDFObjGen og);
     void enqueueObject(QPDFObjectHandle object);
-    void writeObjectStreamOffsets(std::vector<qpdf_offset_t>& offsets, int first_obj);
+    void
+    writeObjectStreamOffsets(std::vector<qpdf_offset_t>& offsets, std::vector<int> const& ids);
     void writeObjectStream(QPDFObjectHandle object);
+    void writeObjectStream(
+        int new_stream_id, std::vector<QPDFObjGen> const& objects, QPDFObjectHandle object);
     void writeObject(QPDFObjectHandle object, int object_stream_index = -1);
     void writeTrailer(
         trailer_e which, int size, bool xref_stream, qpdf_offset_t prev, int linearization_pass);
@@ -495,7 +538,10 @@ class QPDFWriter
         QPDFObjectHandle stream,
         bool& compress_stream,
         bool& is_metadata,
-        std::string* stream_data);
+        std::string* stream_data,
+        std::optional<size_t>* raw_length = nullptr,
+        bool defer_compression = false);
+    void prepareStreams(QPDFObjectHandle stream);
     void unparseObject(
         QPDFObjectHandle object,
         int level,
@@ -553,6 +599,8 @@ class QPDFWriter
     void enqueueObjectsPCLm();
     void indicateProgress(bool decrement, bool finished);
     void writeStandard();
+    void writeObjectsStreaming();
+    void writeIncremental();
     void writeLinearized();
     void enqueuePart(std::vector<QPDFObjectHandle>& part);
     void writeEncryptionDictionary();
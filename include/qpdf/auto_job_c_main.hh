@@ -16,11 +16,15 @@ QPDF_DLL Config* filteredStreamData();
 QPDF_DLL Config* flattenRotation();
 QPDF_DLL Config* generateAppearances();
 QPDF_DLL Config* ignoreXrefStreams();
+QPDF_DLL Config* incrementalUpdate();
 QPDF_DLL Config* isEncrypted();
 QPDF_DLL Config* jsonInput();
+QPDF_DLL Config* jpegOptimizeHuffman();
+QPDF_DLL Config* jpegProgressive();
 QPDF_DLL Config* keepInlineImages();
 QPDF_DLL Config* linearize();
 QPDF_DLL Config* listAttachments();
+QPDF_DLL Config* mmapInput();
 QPDF_DLL Config* newlineBeforeEndstream();
 QPDF_DLL Config* noOriginalObjectIds();
 QPDF_DLL Config* noWarn();
@@ -47,31 +51,40 @@ QPDF_DLL Config* showPages();
 QPDF_DLL Config* showXref();
 QPDF_DLL Config* staticAesIv();
 QPDF_DLL Config* staticId();
+QPDF_DLL Config* streamingWrite();
 QPDF_DLL Config* suppressPasswordRecovery();
 QPDF_DLL Config* suppressRecovery();
 QPDF_DLL Config* testJsonSchema();
 QPDF_DLL Config* verbose();
 QPDF_DLL Config* warningExit0();
 QPDF_DLL Config* withImages();
+QPDF_DLL Config* compressionJobs(std::string const& parameter);
 QPDF_DLL Config* compressionLevel(std::string const& parameter);
 QPDF_DLL Config* copyEncryption(std::string const& parameter);
 QPDF_DLL Config* encryptionFilePassword(std::string const& parameter);
 QPDF_DLL Config* forceVersion(std::string const& parameter);
 QPDF_DLL Config* iiMinBytes(std::string const& parameter);
 QPDF_DLL Config* jobJsonFile(std::string const& parameter);
+QPDF_DLL Config* jpegQuality(std::string const& parameter);
 QPDF_DLL Config* jsonObject(std::string const& parameter);
 QPDF_DLL Config* keepFilesOpenThreshold(std::string const& parameter);
 QPDF_DLL Config* linearizePass1(std::string const& parameter);
 QPDF_DLL Config* minVersion(std::string const& parameter);
+QPDF_DLL Config* objectStreamJobs(std::string const& parameter);
+QPDF_DLL Config* oiMaxMemory(std::string const& parameter);
 QPDF_DLL Config* oiMinArea(std::string const& parameter);
 QPDF_DLL Config* oiMinHeight(std::string const& parameter);
 QPDF_DLL Config* oiMinWidth(std::string const& parameter);
+QPDF_DLL Config* optimizeImagesJobs(std::string const& parameter);
 QPDF_DLL Config* password(std::string const& parameter);
+QPDF_DLL Config* passwordCandidateJobs(std::string const& parameter);
+QPDF_DLL Config* passwordCandidates(std::string const& parameter);
 QPDF_DLL Config* passwordFile(std::string const& parameter);
 QPDF_DLL Config* removeAttachment(std::string const& parameter);
 QPDF_DLL Config* rotate(std::string const& parameter);
 QPDF_DLL Config* showAttachment(std::string const& parameter);
 QPDF_DLL Config* showObject(std::string const& parameter);
+QPDF_DLL Config* splitPagesJobs(std::string const& parameter);
 QPDF_DLL Config* jsonStreamPrefix(std::string const& parameter);
 QPDF_DLL Config* updateFromJson(std::string const& parameter);
 QPDF_DLL Config* collate(std::string const& parameter);
@@ -83,6 +96,7 @@ QPDF_DLL Config* decodeLevel(std::string const& parameter);
 QPDF_DLL Config* flattenAnnotations(std::string const& parameter);
 QPDF_DLL Config* jsonKey(std::string const& parameter);
 QPDF_DLL Config* jsonStreamData(std::string const& parameter);
+QPDF_DLL Config* jpegSubsampling(std::string const& parameter);
 QPDF_DLL Config* keepFilesOpen(std::string const& parameter);
 QPDF_DLL Config* normalizeContent(std::string const& parameter);
 QPDF_DLL Config* objectStreams(std::string const& parameter);
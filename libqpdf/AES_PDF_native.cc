@@ -9,6 +9,130 @@
 #include <stdlib.h>
 #include <string>
 
+// AES instructions are used if the CPU has them. They are checked for at run time, so the compiler
+// doesn't have to target them.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# include <emmintrin.h>
+# include <wmmintrin.h>
+# define QPDF_AES_NI
+# define QPDF_AES_NI_TARGET __attribute__((target("aes,sse2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+# include <wmmintrin.h>
+# define QPDF_AES_NI
+# define QPDF_AES_NI_TARGET
+#endif
+
+static size_t constexpr block_size = QPDFCryptoImpl::rijndael_buf_size;
+
+#ifdef QPDF_AES_NI
+namespace
+{
+    // round_keys holds nrounds + 1 round keys. In CBC mode, iv is updated to continue the chain.
+
+    QPDF_AES_NI_TARGET void
+    load_keys(unsigned char const* round_keys, unsigned int nrounds, __m128i* keys)
+    {
+        for (unsigned int i = 0; i <= nrounds; ++i) {
+            keys[i] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(round_keys + 16 * i));
+        }
+    }
+
+    QPDF_AES_NI_TARGET void
+    ni_encrypt(
+        unsigned char const* round_keys,
+        unsigned int nrounds,
+        bool cbc,
+        unsigned char* iv,
+        unsigned char const* in,
+        unsigned char* out,
+        size_t len)
+    {
+        __m128i k[15];
+        load_keys(round_keys, nrounds, k);
+        __m128i state = cbc ? _mm_loadu_si128(reinterpret_cast<__m128i const*>(iv))
+                            : _mm_setzero_si128();
+        for (size_t offset = 0; offset < len; offset += block_size) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + offset));
+            if (cbc) {
+                x = _mm_xor_si128(x, state);
+            }
+            x = _mm_xor_si128(x, k[0]);
+            for (unsigned int r = 1; r < nrounds; ++r) {
+                x = _mm_aesenc_si128(x, k[r]);
+            }
+            state = _mm_aesenclast_si128(x, k[nrounds]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), state);
+        }
+        if (cbc) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), state);
+        }
+    }
+
+    // Unlike encryption, CBC decryption of a block doesn't depend on the result for the previous
+    // block, so several blocks are decrypted at once to keep the AES unit busy.
+    QPDF_AES_NI_TARGET void
+    ni_decrypt(
+        unsigned char const* round_keys,
+        unsigned int nrounds,
+        bool cbc,
+        unsigned char* iv,
+        unsigned char const* in,
+        unsigned char* out,
+        size_t len)
+    {
+        static size_t constexpr n = 8;
+        __m128i k[15];
+        load_keys(round_keys, nrounds, k);
+        __m128i prev = cbc ? _mm_loadu_si128(reinterpret_cast<__m128i const*>(iv))
+                           : _mm_setzero_si128();
+        size_t offset = 0;
+        for (; offset + n * block_size <= len; offset += n * block_size) {
+            __m128i c[n];
+            __m128i x[n];
+            for (size_t i = 0; i < n; ++i) {
+                c[i] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + offset + 16 * i));
+                x[i] = _mm_xor_si128(c[i], k[0]);
+            }
+            for (unsigned int r = 1; r < nrounds; ++r) {
+                for (size_t i = 0; i < n; ++i) {
+                    x[i] = _mm_aesdec_si128(x[i], k[r]);
+                }
+            }
+            for (size_t i = 0; i < n; ++i) {
+                x[i] = _mm_aesdeclast_si128(x[i], k[nrounds]);
+            }
+            if (cbc) {
+                x[0] = _mm_xor_si128(x[0], prev);
+                for (size_t i = 1; i < n; ++i) {
+                    x[i] = _mm_xor_si128(x[i], c[i - 1]);
+                }
+                prev = c[n - 1];
+            }
+            for (size_t i = 0; i < n; ++i) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset + 16 * i), x[i]);
+            }
+        }
+        for (; offset < len; offset += block_size) {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + offset));
+            __m128i x = _mm_xor_si128(c, k[0]);
+            for (unsigned int r = 1; r < nrounds; ++r) {
+                x = _mm_aesdec_si128(x, k[r]);
+            }
+            x = _mm_aesdeclast_si128(x, k[nrounds]);
+            if (cbc) {
+                x = _mm_xor_si128(x, prev);
+                prev = c;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), x);
+        }
+        if (cbc) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), prev);
+        }
+    }
+} // namespace
+#endif
+
 AES_PDF_native::AES_PDF_native(
     bool encrypt,
     unsigned char const* key,
@@ -31,6 +155,69 @@ AES_PDF_native::AES_PDF_native(
     } else {
         this->nrounds = rijndaelSetupDecrypt(this->rk.get(), this->key.get(), keybits);
     }
+    if (hardwareSupport()) {
+        // The AES instructions use the same round keys as the tables, including the inverse mix
+        // columns transformation of the decryption keys, but as bytes.
+        size_t words = 4 * (this->nrounds + 1);
+        this->round_keys = std::make_unique<unsigned char[]>(4 * words);
+        for (size_t i = 0; i < words; ++i) {
+            uint32_t w = this->rk[i];
+            for (size_t j = 0; j < 4; ++j) {
+                this->round_keys[4 * i + j] = static_cast<unsigned char>(w >> (24 - 8 * j));
+            }
+        }
+    }
+}
+
+bool
+AES_PDF_native::hardwareSupport()
+{
+#ifdef QPDF_AES_NI
+    // Setting QPDF_AES_NI to "disabled" forces the use of the tables so that they can be tested on
+    // CPUs with AES instructions.
+    static bool const supported = []() {
+        std::string value;
+        if (QUtil::get_env("QPDF_AES_NI", &value) && value == "disabled") {
+            return false;
+        }
+# ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 25)) != 0 && (info[3] & (1 << 26)) != 0;
+# else
+        return __builtin_cpu_supports("aes") && __builtin_cpu_supports("sse2");
+# endif
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void
+AES_PDF_native::encryptBlock(unsigned char const* in_data, unsigned char* out_data)
+{
+#ifdef QPDF_AES_NI
+    if (this->round_keys) {
+        ni_encrypt(
+            this->round_keys.get(), this->nrounds, false, nullptr, in_data, out_data, block_size);
+        return;
+    }
+#endif
+    rijndaelEncrypt(this->rk.get(), this->nrounds, in_data, out_data);
+}
+
+void
+AES_PDF_native::decryptBlock(unsigned char const* in_data, unsigned char* out_data)
+{
+#ifdef QPDF_AES_NI
+    if (this->round_keys) {
+        ni_decrypt(
+            this->round_keys.get(), this->nrounds, false, nullptr, in_data, out_data, block_size);
+        return;
+    }
+#endif
+    rijndaelDecrypt(this->rk.get(), this->nrounds, in_data, out_data);
 }
 
 void
@@ -42,12 +229,12 @@ AES_PDF_native::update(unsigned char* in_data, unsigned char* out_data)
                 in_data[i] ^= this->cbc_block[i];
             }
         }
-        rijndaelEncrypt(this->rk.get(), this->nrounds, in_data, out_data);
+        encryptBlock(in_data, out_data);
         if (this->cbc_mode) {
             memcpy(this->cbc_block, out_data, QPDFCryptoImpl::rijndael_buf_size);
         }
     } else {
-        rijndaelDecrypt(this->rk.get(), this->nrounds, in_data, out_data);
+        decryptBlock(in_data, out_data);
         if (this->cbc_mode) {
             for (size_t i = 0; i < QPDFCryptoImpl::rijndael_buf_size; ++i) {
                 out_data[i] ^= this->cbc_block[i];
@@ -56,3 +243,37 @@ AES_PDF_native::update(unsigned char* in_data, unsigned char* out_data)
         }
     }
 }
+
+void
+AES_PDF_native::update(unsigned char const* in_data, unsigned char* out_data, size_t len)
+{
+#ifdef QPDF_AES_NI
+    if (this->round_keys) {
+        if (this->encrypt) {
+            ni_encrypt(
+                this->round_keys.get(),
+                this->nrounds,
+                this->cbc_mode,
+                this->cbc_block,
+                in_data,
+                out_data,
+                len);
+        } else {
+            ni_decrypt(
+                this->round_keys.get(),
+                this->nrounds,
+                this->cbc_mode,
+                this->cbc_block,
+                in_data,
+                out_data,
+                len);
+        }
+        return;
+    }
+#endif
+    unsigned char block[block_size];
+    for (size_t offset = 0; offset < len; offset += block_size) {
+        std::memcpy(block, in_data + offset, block_size);
+        update(block, out_data + offset);
+    }
+}
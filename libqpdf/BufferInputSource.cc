@@ -31,6 +31,15 @@ BufferInputSource::~BufferInputSource()
     }
 }
 
+std::string_view
+BufferInputSource::view() const
+{
+    if (max_offset == 0) {
+        return {};
+    }
+    return {reinterpret_cast<char const*>(buf->getBuffer()), QIntC::to_size(max_offset)};
+}
+
 qpdf_offset_t
 BufferInputSource::findAndSkipNextEOL()
 {
@@ -12,7 +12,7 @@ ContentNormalizer::ContentNormalizer() :
 }
 
 void
-ContentNormalizer::handleToken(QPDFTokenizer::Token const& token)
+ContentNormalizer::handleToken(QPDFTokenizer::TokenView const& token)
 {
     QPDFTokenizer::token_type_e token_type = token.getType();
 
@@ -26,11 +26,11 @@ ContentNormalizer::handleToken(QPDFTokenizer::Token const& token)
     switch (token_type) {
     case QPDFTokenizer::tt_space:
         {
-            std::string const& value = token.getRawValue();
+            auto value = token.getRawValue();
             auto size = value.size();
             size_t pos = 0;
             auto r_pos = value.find('\r');
-            while (r_pos != std::string::npos) {
+            while (r_pos != std::string_view::npos) {
                 if (pos != r_pos) {
                     write(&value[pos], r_pos - pos);
                 }
@@ -53,11 +53,11 @@ ContentNormalizer::handleToken(QPDFTokenizer::Token const& token)
     case QPDFTokenizer::tt_string:
         // Replacing string and name tokens in this way normalizes their representation as this will
         // automatically handle quoting of unprintable characters, etc.
-        write(QPDFObjectHandle::newString(token.getValue()).unparse());
+        write(QPDFObjectHandle::newString(std::string(token.getValue())).unparse());
         break;
 
     case QPDFTokenizer::tt_name:
-        write(Name::normalize(token.getValue()));
+        write(Name::normalize(std::string(token.getValue())));
         break;
 
     default:
@@ -66,8 +66,8 @@ ContentNormalizer::handleToken(QPDFTokenizer::Token const& token)
     }
 
     // tt_string or tt_name
-    std::string const& value = token.getRawValue();
-    if (value.find('\r') != std::string::npos || value.find('\n') != std::string::npos) {
+    auto value = token.getRawValue();
+    if (value.find_first_of("\r\n") != std::string_view::npos) {
         write("\n");
     }
 }
@@ -1,7 +1,9 @@
 #include <qpdf/InputSource_private.hh>
 
+#include <qpdf/CharScan.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QTC.hh>
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
@@ -78,6 +80,29 @@ InputSource::findFirst(char const* start_chars, qpdf_offset_t offset, size_t len
             "InputSource::findSource called with too small or too large of a character sequence");
     }
 
+    if (auto data = qpdf::is::view(*this); !data.empty()) {
+        // The whole input is in memory, so search it in place rather than copying it block by
+        // block. A match must start within [offset, offset + len) and fit before EOF.
+        auto const pattern = std::string_view(start_chars);
+        auto pos = QIntC::to_size(std::max(offset, qpdf_offset_t(0)));
+        auto limit = data.size();
+        if (len != 0 && len < limit - std::min(pos, limit)) {
+            limit = pos + len;
+        }
+        while (pos < limit) {
+            pos = data.find(pattern, pos);
+            if (pos == std::string_view::npos || pos >= limit) {
+                return false;
+            }
+            seek(QIntC::to_offset(pos), SEEK_SET);
+            if (finder.check()) {
+                return true;
+            }
+            ++pos;
+        }
+        return false;
+    }
+
     char* p = nullptr;
     qpdf_offset_t buf_offset = offset;
     size_t bytes_read = 0;
@@ -180,3 +205,109 @@ InputSource::findLast(char const* start_chars, qpdf_offset_t offset, size_t len,
     }
     return found;
 }
+
+std::string_view
+qpdf::is::Buffered::window(qpdf_offset_t offset)
+{
+    if (offset < block_start || offset >= block_start + QIntC::to_offset(block_len)) {
+        if (offset < 0) {
+            return {};
+        }
+        if (!block) {
+            block = std::make_unique<char[]>(block_size);
+        }
+        source->seek(offset, SEEK_SET);
+        block_start = offset;
+        block_len = source->read(block.get(), block_size);
+        if (block_len == 0) {
+            return {};
+        }
+    }
+    auto idx = QIntC::to_size(offset - block_start);
+    return {block.get() + idx, block_len - idx};
+}
+
+void
+qpdf::is::Buffered::seek(qpdf_offset_t offset, int whence)
+{
+    switch (whence) {
+    case SEEK_SET:
+        break;
+
+    case SEEK_CUR:
+        offset += pos;
+        break;
+
+    default:
+        source->seek(offset, whence);
+        pos = source->tell();
+        return;
+    }
+    if (offset < 0) {
+        // Let the underlying source report the error.
+        source->seek(offset, SEEK_SET);
+    }
+    pos = offset;
+}
+
+size_t
+qpdf::is::Buffered::read(char* buffer, size_t length)
+{
+    last_offset = pos;
+    size_t done = 0;
+    while (done < length) {
+        bool in_block = pos >= block_start && pos < block_start + QIntC::to_offset(block_len);
+        if (!in_block && length - done >= block_size) {
+            // Large reads that start outside the buffer go directly to the underlying source.
+            source->seek(pos, SEEK_SET);
+            auto len = source->read(buffer + done, length - done);
+            done += len;
+            pos += QIntC::to_offset(len);
+            break;
+        }
+        auto data = window(pos);
+        if (data.empty()) {
+            break;
+        }
+        auto len = std::min(data.size(), length - done);
+        memcpy(buffer + done, data.data(), len);
+        done += len;
+        pos += QIntC::to_offset(len);
+    }
+    if (done == 0 && length > 0) {
+        seek(0, SEEK_END);
+        last_offset = pos;
+    }
+    return done;
+}
+
+qpdf_offset_t
+qpdf::is::Buffered::findAndSkipNextEOL()
+{
+    bool found = false;
+    qpdf_offset_t result = 0;
+    while (true) {
+        auto data = window(pos);
+        if (data.empty()) {
+            seek(0, SEEK_END);
+            return found ? result : pos;
+        }
+        size_t i = 0;
+        if (!found) {
+            i = scan::find_eol(data, 0);
+            if (i < data.size()) {
+                found = true;
+                result = pos + QIntC::to_offset(i);
+            }
+        }
+        if (found) {
+            while (i < data.size() && (data[i] == '\r' || data[i] == '\n')) {
+                ++i;
+            }
+        }
+        pos += QIntC::to_offset(i);
+        if (found && i < data.size()) {
+            return result;
+        }
+    }
+}
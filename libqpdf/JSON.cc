@@ -1,11 +1,14 @@
 #include <qpdf/JSON.hh>
 
+#include <qpdf/JSON_parser.hh>
 #include <qpdf/JSON_writer.hh>
 
 #include <qpdf/BufferInputSource.hh>
+#include <qpdf/CharScan.hh>
 #include <qpdf/Pl_Base64.hh>
 #include <qpdf/Pl_Concatenate.hh>
 #include <qpdf/Pl_String.hh>
+#include <qpdf/QIntC.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
 #include <qpdf/Util.hh>
@@ -588,9 +591,11 @@ namespace
     class JSONParser
     {
       public:
-        JSONParser(InputSource& is, JSON::Reactor* reactor) :
+        JSONParser(
+            InputSource& is, JSON::Reactor* reactor, json::Handler* handler = nullptr) :
             is(is),
             reactor(reactor),
+            handler(handler),
             p(buf)
         {
         }
@@ -636,18 +641,26 @@ namespace
 
         struct StackFrame
         {
-            StackFrame(parser_state_e state, JSON& item) :
+            StackFrame(
+                parser_state_e state, JSON& item, json::Value::type_e type, qpdf_offset_t start) :
                 state(state),
-                item(item)
+                item(item),
+                type(type),
+                start(start)
             {
             }
 
             parser_state_e state;
+            // Not set when parsing for a json::Handler
             JSON item;
+            json::Value::type_e type;
+            qpdf_offset_t start;
         };
 
         void getToken();
         void handleToken();
+        void containerEnd();
+        JSON makeItem(json::Value const& value);
         void tokenError();
         static void handle_u_code(
             unsigned long codepoint,
@@ -662,6 +675,7 @@ namespace
 
         InputSource& is;
         JSON::Reactor* reactor;
+        json::Handler* handler;
         lex_state_e lex_state{ls_top};
         char buf[16384];
         size_t bytes{0};
@@ -671,6 +685,8 @@ namespace
         qpdf_offset_t offset{0};
         bool done{false};
         std::string token;
+        // Set while reading a string whose text the handler doesn't want
+        bool skip_text{false};
         qpdf_offset_t token_start{0};
         parser_state_e parser_state{ps_top};
         std::vector<StackFrame> stack;
@@ -836,6 +852,22 @@ JSONParser::getToken()
             }
         }
 
+        // Deal with runs of white space between tokens and of ordinary characters in strings in
+        // one go. The character that ends the run is handled below.
+        if (lex_state == ls_string || lex_state == ls_top) {
+            std::string_view data(p, QIntC::to_size(buf + bytes - p));
+            size_t n = lex_state == ls_string ? scan::find_json_string_special(data, 0)
+                                              : scan::skip_json_space(data, 0);
+            if (n > 0) {
+                if (lex_state == ls_string && !skip_text) {
+                    token.append(p, n);
+                }
+                p += n;
+                offset += QIntC::to_offset(n);
+                continue;
+            }
+        }
+
         if ((*p < 32 && *p >= 0)) {
             if (*p == '\t' || *p == '\n' || *p == '\r') {
                 // Legal white space not permitted in strings. This will always end the current
@@ -920,6 +952,8 @@ JSONParser::getToken()
             case ls_top:
                 token_start = offset;
                 if (*p == '"') {
+                    skip_text = handler && parser_state == ps_dict_after_colon &&
+                        handler->skipStringValue(dict_key);
                     ignore(ls_string);
                 } else if ((*p >= 'a') && (*p <= 'z')) {
                     append(ls_alpha);
@@ -1101,15 +1135,11 @@ JSONParser::getToken()
     }
 
     // We only get here if on end of input or if the last character was a control character or other
-    // delimiter.
+    // delimiter. Check the state rather than token, which is empty for a string whose text is not
+    // collected or that has no characters yet.
 
-    if (!token.empty()) {
+    if (lex_state != ls_top) {
         switch (lex_state) {
-        case ls_top:
-            // Can't happen
-            throw std::logic_error("tok_start set in ls_top while parsing");
-            break;
-
         case ls_number_leading_zero:
         case ls_number_before_point:
         case ls_number_after_point:
@@ -1141,19 +1171,17 @@ JSONParser::handleToken()
             ": material follows end of object: " + token);
     }
 
-    const static JSON null_item = JSON::makeNull();
-    JSON item;
-    auto tos = stack.empty() ? null_item : stack.back().item;
     auto ls = lex_state;
     lex_state = ls_top;
+    json::Value::type_e type = json::Value::t_null;
 
     switch (ls) {
     case ls_begin_dict:
-        item = JSON::makeDictionary();
+        type = json::Value::t_dictionary;
         break;
 
     case ls_begin_array:
-        item = JSON::makeArray();
+        type = json::Value::t_array;
         break;
 
     case ls_colon:
@@ -1186,14 +1214,7 @@ JSONParser::handleToken()
             throw std::runtime_error(
                 "JSON: offset " + std::to_string(offset) + ": unexpected array end delimiter");
         }
-        parser_state = stack.back().state;
-        tos.setEnd(offset);
-        if (reactor) {
-            reactor->containerEnd(tos);
-        }
-        if (parser_state != ps_done) {
-            stack.pop_back();
-        }
+        containerEnd();
         return;
 
     case ls_end_dict:
@@ -1202,27 +1223,18 @@ JSONParser::handleToken()
             throw std::runtime_error(
                 "JSON: offset " + std::to_string(offset) + ": unexpected dictionary end delimiter");
         }
-        parser_state = stack.back().state;
-        tos.setEnd(offset);
-        if (reactor) {
-            reactor->containerEnd(tos);
-        }
-        if (parser_state != ps_done) {
-            stack.pop_back();
-        }
+        containerEnd();
         return;
 
     case ls_number:
-        item = JSON::makeNumber(token);
+        type = json::Value::t_number;
         break;
 
     case ls_alpha:
-        if (token == "true") {
-            item = JSON::makeBool(true);
-        } else if (token == "false") {
-            item = JSON::makeBool(false);
+        if (token == "true" || token == "false") {
+            type = json::Value::t_bool;
         } else if (token == "null") {
-            item = JSON::makeNull();
+            type = json::Value::t_null;
         } else {
             QTC::TC("libtests", "JSON parse invalid keyword");
             throw std::runtime_error(
@@ -1237,7 +1249,7 @@ JSONParser::handleToken()
             parser_state = ps_dict_after_key;
             return;
         } else {
-            item = JSON::makeString(token);
+            type = json::Value::t_string;
         }
         break;
 
@@ -1247,8 +1259,14 @@ JSONParser::handleToken()
         break;
     }
 
-    item.setStart(token_start);
-    item.setEnd(offset);
+    json::Value value(type, skip_text ? std::string_view() : token, token_start, offset);
+    skip_text = false;
+    bool is_container = value.isDictionary() || value.isArray();
+    // When parsing for a json::Handler, no JSON objects are created.
+    JSON item;
+    if (!handler) {
+        item = makeItem(value);
+    }
 
     switch (parser_state) {
     case ps_dict_begin:
@@ -1259,23 +1277,27 @@ JSONParser::handleToken()
         break;
 
     case ps_dict_after_colon:
-        if (!reactor || !reactor->dictionaryItem(dict_key, item)) {
-            tos.addDictionaryMember(dict_key, item);
+        if (handler) {
+            handler->dictionaryItem(dict_key, value);
+        } else if (!reactor || !reactor->dictionaryItem(dict_key, item)) {
+            stack.back().item.addDictionaryMember(dict_key, item);
         }
         parser_state = ps_dict_after_item;
         break;
 
     case ps_array_begin:
     case ps_array_after_comma:
-        if (!reactor || !reactor->arrayItem(item)) {
-            tos.addArrayElement(item);
+        if (handler) {
+            handler->arrayItem(value);
+        } else if (!reactor || !reactor->arrayItem(item)) {
+            stack.back().item.addArrayElement(item);
         }
         parser_state = ps_array_after_item;
         break;
 
     case ps_top:
-        if (!(item.isDictionary() || item.isArray())) {
-            stack.emplace_back(ps_done, item);
+        if (!is_container) {
+            stack.emplace_back(ps_done, item, type, token_start);
             parser_state = ps_done;
             return;
         }
@@ -1303,18 +1325,22 @@ JSONParser::handleToken()
         throw std::logic_error("JSONParser::handleToken: unexpected parser state");
     }
 
-    if (item.isDictionary() || item.isArray()) {
-        stack.emplace_back(parser_state, item);
+    if (is_container) {
+        stack.emplace_back(parser_state, item, type, token_start);
         // Calling container start method is postponed until after adding the containers to their
         // parent containers, if any. This makes it much easier to keep track of the current nesting
         // level.
-        if (item.isDictionary()) {
-            if (reactor) {
+        if (value.isDictionary()) {
+            if (handler) {
+                handler->dictionaryStart();
+            } else if (reactor) {
                 reactor->dictionaryStart();
             }
             parser_state = ps_dict_begin;
-        } else if (item.isArray()) {
-            if (reactor) {
+        } else {
+            if (handler) {
+                handler->arrayStart();
+            } else if (reactor) {
                 reactor->arrayStart();
             }
             parser_state = ps_array_begin;
@@ -1327,6 +1353,55 @@ JSONParser::handleToken()
     }
 }
 
+void
+JSONParser::containerEnd()
+{
+    auto& tos = stack.back();
+    parser_state = tos.state;
+    if (handler) {
+        handler->containerEnd(json::Value(tos.type, {}, tos.start, offset));
+    } else {
+        tos.item.setEnd(offset);
+        if (reactor) {
+            reactor->containerEnd(tos.item);
+        }
+    }
+    if (parser_state != ps_done) {
+        stack.pop_back();
+    }
+}
+
+JSON
+JSONParser::makeItem(json::Value const& value)
+{
+    JSON item;
+    bool bool_v = false;
+    switch (value.getType()) {
+    case json::Value::t_dictionary:
+        item = JSON::makeDictionary();
+        break;
+    case json::Value::t_array:
+        item = JSON::makeArray();
+        break;
+    case json::Value::t_null:
+        item = JSON::makeNull();
+        break;
+    case json::Value::t_bool:
+        value.getBool(bool_v);
+        item = JSON::makeBool(bool_v);
+        break;
+    case json::Value::t_number:
+        item = JSON::makeNumber(token);
+        break;
+    case json::Value::t_string:
+        item = JSON::makeString(token);
+        break;
+    }
+    item.setStart(value.getStart());
+    item.setEnd(value.getEnd());
+    return item;
+}
+
 JSON
 JSONParser::parse()
 {
@@ -1338,11 +1413,15 @@ JSONParser::parse()
         QTC::TC("libtests", "JSON parse premature EOF");
         throw std::runtime_error("JSON: premature end of input");
     }
-    auto const& tos = stack.back().item;
-    if (reactor && !(tos.isArray() || tos.isDictionary())) {
-        reactor->topLevelScalar();
+    auto const& tos = stack.back();
+    if (!(tos.type == json::Value::t_dictionary || tos.type == json::Value::t_array)) {
+        if (handler) {
+            handler->topLevelScalar();
+        } else if (reactor) {
+            reactor->topLevelScalar();
+        }
     }
-    return tos;
+    return tos.item;
 }
 
 JSON
@@ -1352,6 +1431,13 @@ JSON::parse(InputSource& is, Reactor* reactor)
     return jp.parse();
 }
 
+void
+json::parse(InputSource& is, Handler& handler)
+{
+    JSONParser jp(is, nullptr, &handler);
+    jp.parse();
+}
+
 JSON
 JSON::parse(std::string const& s)
 {
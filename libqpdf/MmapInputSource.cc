@@ -0,0 +1,160 @@
+#include <qpdf/qpdf-config.h> // include first for large file support
+
+#include <qpdf/MmapInputSource.hh>
+
+#include <qpdf/QIntC.hh>
+#include <qpdf/QUtil.hh>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef HAVE_MMAP
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+MmapInputSource::MmapInputSource(char const* filename) :
+    filename(filename)
+{
+#ifdef HAVE_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        QUtil::throw_system_error(std::string("open ") + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* p = mmap(nullptr, QIntC::to_size(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            data = static_cast<char const*>(p);
+            size = QIntC::to_size(st.st_size);
+            mapped = true;
+# ifdef MADV_SEQUENTIAL
+            // Most access is front to back, so encourage read-ahead.
+            madvise(p, size, MADV_SEQUENTIAL);
+# endif
+        }
+    }
+    close(fd);
+    if (mapped) {
+        return;
+    }
+#endif
+    // Memory mapping is unavailable or failed, or the file is empty or not a regular file.
+    contents = QUtil::read_file_into_string(filename);
+    data = contents.data();
+    size = contents.size();
+}
+
+MmapInputSource::~MmapInputSource()
+{
+    // Must be explicit and not inline -- see QPDF_DLL_CLASS in README-maintainer
+#ifdef HAVE_MMAP
+    if (mapped) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
+std::string_view
+MmapInputSource::view() const
+{
+    return {data, size};
+}
+
+qpdf_offset_t
+MmapInputSource::findAndSkipNextEOL()
+{
+    if (cur_offset < 0) {
+        throw std::logic_error("INTERNAL ERROR: MmapInputSource offset < 0");
+    }
+    auto end_pos = QIntC::to_offset(size);
+    if (cur_offset >= end_pos) {
+        last_offset = end_pos;
+        cur_offset = end_pos;
+        return end_pos;
+    }
+
+    auto eol = view().find_first_of("\r\n", QIntC::to_size(cur_offset));
+    if (eol == std::string_view::npos) {
+        cur_offset = end_pos;
+        return end_pos;
+    }
+    auto next = view().find_first_not_of("\r\n", eol);
+    cur_offset = next == std::string_view::npos ? end_pos : QIntC::to_offset(next);
+    return QIntC::to_offset(eol);
+}
+
+std::string const&
+MmapInputSource::getName() const
+{
+    return filename;
+}
+
+qpdf_offset_t
+MmapInputSource::tell()
+{
+    return cur_offset;
+}
+
+void
+MmapInputSource::seek(qpdf_offset_t offset, int whence)
+{
+    switch (whence) {
+    case SEEK_SET:
+        cur_offset = offset;
+        break;
+
+    case SEEK_END:
+        QIntC::range_check(QIntC::to_offset(size), offset);
+        cur_offset = QIntC::to_offset(size) + offset;
+        break;
+
+    case SEEK_CUR:
+        QIntC::range_check(cur_offset, offset);
+        cur_offset += offset;
+        break;
+
+    default:
+        throw std::logic_error("INTERNAL ERROR: invalid argument to MmapInputSource::seek");
+        break;
+    }
+
+    if (cur_offset < 0) {
+        throw std::runtime_error(filename + ": seek before beginning of file");
+    }
+}
+
+void
+MmapInputSource::rewind()
+{
+    cur_offset = 0;
+}
+
+size_t
+MmapInputSource::read(char* buffer, size_t length)
+{
+    if (cur_offset < 0) {
+        throw std::logic_error("INTERNAL ERROR: MmapInputSource offset < 0");
+    }
+    auto end_pos = QIntC::to_offset(size);
+    if (cur_offset >= end_pos) {
+        last_offset = end_pos;
+        return 0;
+    }
+
+    last_offset = cur_offset;
+    size_t len = std::min(QIntC::to_size(end_pos - cur_offset), length);
+    memcpy(buffer, data + cur_offset, len);
+    cur_offset += QIntC::to_offset(len);
+    return len;
+}
+
+void
+MmapInputSource::unreadCh(char ch)
+{
+    if (cur_offset > 0) {
+        --cur_offset;
+    }
+}
@@ -0,0 +1,24 @@
+#include <qpdf/ObjectPool.hh>
+
+#include <algorithm>
+
+using namespace qpdf;
+
+void
+ObjectPool::add_chunk()
+{
+    auto n = min_chunk_blocks << std::min(chunks.size(), chunk_doublings);
+    chunks.emplace_back(new std::max_align_t[n * block_size / alignment]);
+    auto* const start = reinterpret_cast<char*>(chunks.back().get());
+    for (size_t i = n; i > 0; --i) {
+        free_list = new (start + (i - 1) * block_size) FreeBlock{free_list};
+    }
+}
+
+void
+ObjectPool::release() noexcept
+{
+    if (--refs == 0) {
+        delete this;
+    }
+}
@@ -1,8 +1,10 @@
 #include <qpdf/Pl_AES_PDF.hh>
 
 #include <qpdf/QIntC.hh>
+#include <qpdf/QPDFCryptoBulk.hh>
 #include <qpdf/QPDFCryptoProvider.hh>
 #include <qpdf/QUtil.hh>
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 #include <string>
@@ -17,6 +19,7 @@ Pl_AES_PDF::Pl_AES_PDF(
     size_t key_bytes) :
     Pipeline(identifier, next),
     crypto(QPDFCryptoProvider::getImpl()),
+    bulk(dynamic_cast<QPDFCryptoBulk*>(crypto.get())),
     encrypt(encrypt),
     key_bytes(key_bytes)
 {
@@ -73,6 +76,20 @@ Pl_AES_PDF::useStaticIV()
 void
 Pl_AES_PDF::write(unsigned char const* data, size_t len)
 {
+    if (bulk && cbc_mode) {
+        auto p = reinterpret_cast<char const*>(data);
+        while (len > 0) {
+            size_t bytes = std::min(len, bulk_size - bulk_in.size());
+            bulk_in.append(p, bytes);
+            p += bytes;
+            len -= bytes;
+            if (bulk_in.size() == bulk_size) {
+                processBulk(false);
+            }
+        }
+        return;
+    }
+
     size_t bytes_left = len;
     unsigned char const* p = data;
 
@@ -93,6 +110,11 @@ Pl_AES_PDF::write(unsigned char const* data, size_t len)
 void
 Pl_AES_PDF::finish()
 {
+    if (bulk && cbc_mode) {
+        processBulk(true);
+        next()->finish();
+        return;
+    }
     if (this->encrypt) {
         if (this->offset == this->buf_size) {
             flush(false);
@@ -197,3 +219,69 @@ Pl_AES_PDF::flush(bool strip_padding)
     this->offset = 0;
     next()->write(this->outbuf, bytes);
 }
+
+void
+Pl_AES_PDF::processBulk(bool at_end)
+{
+    // This does the same as write, finish and flush do a block at a time.
+    if (at_end) {
+        size_t extra = bulk_in.size() % buf_size;
+        if (encrypt) {
+            if (disable_padding) {
+                bulk_in.resize(bulk_in.size() - extra);
+            } else {
+                bulk_in.append(buf_size - extra, static_cast<char>(buf_size - extra));
+            }
+        } else if (extra != 0 || bulk_in.empty()) {
+            bulk_in.append(buf_size - extra, '\0');
+        }
+    }
+    // Unless this is the end of the data, keep the last block, which may have to have its padding
+    // removed, and any incomplete block.
+    size_t len = at_end ? bulk_in.size() : (bulk_in.size() - 1) / buf_size * buf_size;
+    if (len == 0) {
+        // Only possible at the end when encrypting less than a block without padding.
+        bulk_in.clear();
+        return;
+    }
+    auto in = reinterpret_cast<unsigned char const*>(bulk_in.data());
+    size_t consumed = len;
+    if (first) {
+        if (encrypt || use_zero_iv || use_specified_iv) {
+            initializeVector();
+            if (encrypt && !(use_zero_iv || use_specified_iv)) {
+                next()->write(cbc_block, buf_size);
+            }
+        } else {
+            // Take the first block of input as the initialization vector.
+            std::memcpy(cbc_block, in, buf_size);
+            in += buf_size;
+            len -= buf_size;
+        }
+        first = false;
+    }
+    if (len > 0) {
+        bulk_out.resize(len);
+        auto out = reinterpret_cast<unsigned char*>(bulk_out.data());
+        bulk->rijndael_cbc(encrypt, key.get(), key_bytes, cbc_block, in, out, len);
+        std::memcpy(cbc_block, (encrypt ? out : in) + len - buf_size, buf_size);
+        size_t bytes = len;
+        if (at_end && !encrypt && !disable_padding) {
+            unsigned char last = out[len - 1];
+            if (last <= buf_size) {
+                bool strip = true;
+                for (unsigned int i = 1; i <= last; ++i) {
+                    if (out[len - i] != last) {
+                        strip = false;
+                        break;
+                    }
+                }
+                if (strip) {
+                    bytes -= last;
+                }
+            }
+        }
+        next()->write(out, bytes);
+    }
+    bulk_in.erase(0, at_end ? bulk_in.size() : consumed);
+}
@@ -0,0 +1,300 @@
+#include <qpdf/Pl_ContentParser.hh>
+
+#include <qpdf/Buffer.hh>
+#include <qpdf/QIntC.hh>
+#include <qpdf/QPDF.hh>
+#include <qpdf/QPDFParser.hh>
+#include <qpdf/QTC.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+using namespace qpdf;
+
+namespace
+{
+    // An input source over the pending data that records whether anything tried to read up to the
+    // end of it. Unlike is::OffsetBuffer, it is not recognized by is::view, so all access,
+    // including the look-ahead done while searching for the end of an inline image, goes through
+    // read.
+    class WatchedInput final: public InputSource
+    {
+      public:
+        WatchedInput(std::string const& name, std::string_view data, qpdf_offset_t start) :
+            name(name),
+            data(data),
+            start(start)
+        {
+            last_offset = start;
+        }
+
+        ~WatchedInput() final = default;
+
+        bool
+        reachedEnd() const
+        {
+            return reached_end;
+        }
+
+        qpdf_offset_t
+        findAndSkipNextEOL() final
+        {
+            reached_end = true;
+            auto i = std::min(data.find_first_of("\r\n", pos), data.size());
+            auto result = start + QIntC::to_offset(i);
+            while (i < data.size() && (data[i] == '\r' || data[i] == '\n')) {
+                ++i;
+            }
+            pos = i;
+            return result;
+        }
+
+        std::string const&
+        getName() const final
+        {
+            return name;
+        }
+
+        qpdf_offset_t
+        tell() final
+        {
+            return start + QIntC::to_offset(pos);
+        }
+
+        void
+        seek(qpdf_offset_t offset, int whence) final
+        {
+            switch (whence) {
+            case SEEK_SET:
+                offset -= start;
+                break;
+
+            case SEEK_END:
+                reached_end = true;
+                offset += QIntC::to_offset(data.size());
+                break;
+
+            case SEEK_CUR:
+                offset += QIntC::to_offset(pos);
+                break;
+
+            default:
+                throw std::logic_error("INTERNAL ERROR: invalid argument to WatchedInput::seek");
+            }
+            if (offset < 0) {
+                throw std::runtime_error(name + ": seek before beginning of buffer");
+            }
+            pos = QIntC::to_size(offset);
+        }
+
+        void
+        rewind() final
+        {
+            pos = 0;
+        }
+
+        size_t
+        read(char* buffer, size_t length) final
+        {
+            if (length >= data.size() - std::min(pos, data.size())) {
+                reached_end = true;
+            }
+            if (pos >= data.size()) {
+                last_offset = start + QIntC::to_offset(data.size());
+                return 0;
+            }
+            last_offset = tell();
+            auto len = std::min(data.size() - pos, length);
+            memcpy(buffer, data.data() + pos, len);
+            pos += len;
+            return len;
+        }
+
+        void
+        unreadCh(char) final
+        {
+            if (pos > 0) {
+                --pos;
+            }
+        }
+
+      private:
+        std::string name;
+        std::string_view data;
+        qpdf_offset_t start;
+        size_t pos{0};
+        bool reached_end{false};
+    };
+} // namespace
+
+static void
+warn(QPDF* context, QPDFExc const& e)
+{
+    // As in QPDFObjectHandle, warn through the QPDF object if there is one. Otherwise, throw.
+    if (context) {
+        context->warn(e);
+    } else {
+        throw e;
+    }
+}
+
+Pl_ContentParser::Pl_ContentParser(
+    char const* identifier,
+    std::string const& description,
+    QPDFObjectHandle::ParserCallbacks* callbacks,
+    QPDF* context,
+    size_t block_size) :
+    Pipeline(identifier, nullptr),
+    description(description),
+    sp_description(QPDFParser::make_description(description, "content")),
+    callbacks(callbacks),
+    context(context),
+    block_size(std::max(block_size, size_t(1))),
+    wanted(this->block_size)
+{
+}
+
+void
+Pl_ContentParser::write(unsigned char const* data, size_t len)
+{
+    if (error) {
+        return;
+    }
+    pending.append(reinterpret_cast<char const*>(data), len);
+    if (pending.size() >= wanted) {
+        parse(false);
+    }
+}
+
+void
+Pl_ContentParser::finish()
+{
+    if (!error) {
+        parse(true);
+    }
+    pending.clear();
+    pending.shrink_to_fit();
+    pending_offset = 0;
+    wanted = block_size;
+    expect_inline_image = false;
+}
+
+void
+Pl_ContentParser::rethrow()
+{
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void
+Pl_ContentParser::parse(bool at_end)
+{
+    auto const end = pending_offset + QIntC::to_offset(pending.size());
+    qpdf_offset_t done = pending_offset;
+    try {
+        Buffer buffer(reinterpret_cast<unsigned char*>(pending.data()), pending.size());
+        is::OffsetBuffer input(description, &buffer, pending_offset);
+        Tokenizer tokenizer;
+        tokenizer.allowEOF();
+        // At the end, an ID operator is followed by an inline image even if there is no more data.
+        while (done < end || (at_end && expect_inline_image)) {
+            if (!(expect_inline_image ? parseInlineImage(done, at_end)
+                                      : parseObject(input, tokenizer, done, at_end))) {
+                break;
+            }
+        }
+    } catch (...) {
+        error = std::current_exception();
+        pending.clear();
+        return;
+    }
+    // Keep the unparsed data. If an object is still incomplete after a block's worth of data, wait
+    // for it to double in size before trying again so that parsing very large objects is not
+    // quadratic.
+    auto n = QIntC::to_size(done - pending_offset);
+    pending.erase(0, n);
+    pending_offset = done;
+    wanted = std::max(block_size, 2 * pending.size());
+}
+
+bool
+Pl_ContentParser::parseObject(
+    is::OffsetBuffer& input, Tokenizer& tokenizer, qpdf_offset_t& done, bool at_end)
+{
+    auto const end = pending_offset + QIntC::to_offset(pending.size());
+
+    // Read a token and seek to the beginning. The offset we get from this process is the beginning
+    // of the next non-ignorable (space, comment) token. This way, the offset and length don't
+    // include ignorable content.
+    input.seek(done, SEEK_SET);
+    tokenizer.nextToken(input, "content", true);
+    qpdf_offset_t offset = input.getLastOffset();
+    input.seek(offset, SEEK_SET);
+    warnings.clear();
+    auto obj = QPDFParser::parse_content(input, sp_description, tokenizer, context, &warnings);
+    // The parser only looks at the tokens of the object, and the tokenizer only stops short of the
+    // end of the data when it has seen the character that ends the last token. If parsing ran into
+    // the end, the object may continue in data that has not been written yet.
+    if (!at_end && input.tell() >= end) {
+        return false;
+    }
+    for (auto const& w: warnings) {
+        warn(context, w);
+    }
+    if (!obj) {
+        // EOF
+        done = end;
+        return true;
+    }
+    done = input.tell();
+    callbacks->handleObject(obj, QIntC::to_size(offset), QIntC::to_size(done - offset));
+    if (obj.isOperator() && (obj.getOperatorValue() == "ID")) {
+        expect_inline_image = true;
+    }
+    return true;
+}
+
+bool
+Pl_ContentParser::parseInlineImage(qpdf_offset_t& done, bool at_end)
+{
+    // Finding the end of the image involves looking at the tokens that follow it, so use an input
+    // that tells us whether that look-ahead needed data that has not been written yet.
+    WatchedInput input(description, pending, pending_offset);
+    input.seek(done, SEEK_SET);
+    // Discard next character; it is the space after ID that terminated the token. Read until end
+    // of inline image.
+    char ch;
+    input.read(&ch, 1);
+    Tokenizer tokenizer;
+    tokenizer.allowEOF();
+    tokenizer.expectInlineImage(input);
+    tokenizer.nextToken(input, description);
+    if (!at_end && input.reachedEnd()) {
+        return false;
+    }
+    qpdf_offset_t offset = input.getLastOffset();
+    size_t length = QIntC::to_size(input.tell() - offset);
+    if (tokenizer.getType() == QPDFTokenizer::tt_bad) {
+        QTC::TC("qpdf", "QPDFObjectHandle EOF in inline image");
+        warn(
+            context,
+            QPDFExc(
+                qpdf_e_damaged_pdf,
+                description,
+                "stream data",
+                input.tell(),
+                "EOF found while reading inline image"));
+    } else {
+        QTC::TC("qpdf", "QPDFObjectHandle inline image token");
+        callbacks->handleObject(
+            QPDFObjectHandle::newInlineImage(tokenizer.getValue()),
+            QIntC::to_size(offset),
+            length);
+    }
+    done = input.tell();
+    expect_inline_image = false;
+    return true;
+}
@@ -97,6 +97,10 @@ class Pl_DCT::Members
     int components{1};
     J_COLOR_SPACE color_space{JCS_GRAYSCALE};
 
+    int quality{0};
+    subsampling_e subsampling{s_default};
+    bool optimize_huffman{false};
+    bool progressive{false};
     CompressConfig* config_callback{nullptr};
 };
 
@@ -141,6 +145,33 @@ Pl_DCT::Pl_DCT(
 {
 }
 
+void
+Pl_DCT::setQuality(int quality)
+{
+    if (quality < 1 || quality > 100) {
+        throw std::logic_error("Pl_DCT: quality must be between 1 and 100");
+    }
+    m->quality = quality;
+}
+
+void
+Pl_DCT::setSubsampling(subsampling_e subsampling)
+{
+    m->subsampling = subsampling;
+}
+
+void
+Pl_DCT::setOptimizeHuffman(bool val)
+{
+    m->optimize_huffman = val;
+}
+
+void
+Pl_DCT::setProgressive(bool val)
+{
+    m->progressive = val;
+}
+
 // Must be explicit and not inline -- see QPDF_DLL_CLASS in README-maintainer
 Pl_DCT::~Pl_DCT() = default;
 
@@ -336,6 +367,21 @@ Pl_DCT::compress(void* cinfo_p, Buffer* b)
     cinfo->input_components = m->components;
     cinfo->in_color_space = m->color_space;
     jpeg_set_defaults(cinfo);
+    if (m->quality > 0) {
+        jpeg_set_quality(cinfo, m->quality, TRUE);
+    }
+    if (m->subsampling != s_default && cinfo->jpeg_color_space == JCS_YCbCr) {
+        // Subsampling is expressed by the sampling factors of the luminance component relative
+        // to the chroma components, which are left at 1x1.
+        cinfo->comp_info[0].h_samp_factor = (m->subsampling == s_444 ? 1 : 2);
+        cinfo->comp_info[0].v_samp_factor = (m->subsampling == s_420 ? 2 : 1);
+    }
+    if (m->optimize_huffman) {
+        cinfo->optimize_coding = TRUE;
+    }
+    if (m->progressive) {
+        jpeg_simple_progression(cinfo);
+    }
     if (m->config_callback) {
         m->config_callback->apply(cinfo);
     }
@@ -1,6 +1,7 @@
 #include <qpdf/Pl_QPDFTokenizer.hh>
 
 #include <qpdf/BufferInputSource.hh>
+#include <qpdf/QPDFTokenizer_private.hh>
 #include <qpdf/QTC.hh>
 #include <stdexcept>
 
@@ -12,7 +13,9 @@ class Pl_QPDFTokenizer::Members
     ~Members() = default;
 
     QPDFObjectHandle::TokenFilter* filter{nullptr};
-    QPDFTokenizer tokenizer;
+    // filter if it accepts views of tokens
+    QPDFObjectHandle::TokenViewFilter* view_filter{nullptr};
+    qpdf::Tokenizer tokenizer;
     Pl_Buffer buf{"tokenizer buffer"};
 };
 
@@ -22,6 +25,7 @@ Pl_QPDFTokenizer::Pl_QPDFTokenizer(
     m(std::make_unique<Members>())
 {
     m->filter = filter;
+    m->view_filter = dynamic_cast<QPDFObjectHandle::TokenViewFilter*>(filter);
     QPDFObjectHandle::TokenFilter::PipelineAccessor::setPipeline(m->filter, next);
     m->tokenizer.allowEOF();
     m->tokenizer.includeIgnorable();
@@ -42,20 +46,30 @@ Pl_QPDFTokenizer::finish()
     m->buf.finish();
     auto input = BufferInputSource("tokenizer data", m->buf.getBuffer(), true);
     std::string empty;
+    auto handle = [this](QPDFTokenizer::TokenView const& token) {
+        // Filters that take views are passed views of the tokenizer's buffers. Others are passed
+        // copies.
+        if (m->view_filter) {
+            m->view_filter->handleToken(token);
+        } else {
+            m->filter->handleToken(token.toToken());
+        }
+    };
     while (true) {
-        auto token = m->tokenizer.readToken(input, empty, true);
-        m->filter->handleToken(token);
+        auto& t = m->tokenizer;
+        t.nextToken(input, empty);
+        QPDFTokenizer::TokenView token(
+            t.getType(), t.getValue(), t.getRawValue(), t.getErrorMessage());
+        handle(token);
         if (token.getType() == QPDFTokenizer::tt_eof) {
             break;
         } else if (token.isWord("ID")) {
             // Read the space after the ID.
             char ch = ' ';
             input.read(&ch, 1);
-            m->filter->handleToken(
-                // line-break
-                QPDFTokenizer::Token(QPDFTokenizer::tt_space, std::string(1, ch)));
+            handle(QPDFTokenizer::TokenView(QPDFTokenizer::tt_space, {&ch, 1}, {&ch, 1}));
             QTC::TC("qpdf", "Pl_QPDFTokenizer found ID");
-            m->tokenizer.expectInlineImage(input);
+            t.expectInlineImage(input);
         }
     }
     m->filter->handleEOF();
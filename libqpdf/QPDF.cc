@@ -9,11 +9,13 @@
 #include <map>
 #include <regex>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include <qpdf/BufferInputSource.hh>
 #include <qpdf/FileInputSource.hh>
 #include <qpdf/InputSource_private.hh>
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/OffsetInputSource.hh>
 #include <qpdf/Pipeline.hh>
 #include <qpdf/QPDFExc.hh>
@@ -242,15 +244,21 @@ QPDF::create()
 void
 QPDF::processFile(char const* filename, char const* password)
 {
-    auto* fi = new FileInputSource(filename);
-    processInputSource(std::shared_ptr<InputSource>(fi), password);
+    if (m->mmap_input) {
+        processInputSource(std::make_shared<MmapInputSource>(filename), password);
+        return;
+    }
+    processInputSource(
+        std::make_shared<is::Buffered>(std::make_shared<FileInputSource>(filename)), password);
 }
 
 void
 QPDF::processFile(char const* description, FILE* filep, bool close_file, char const* password)
 {
-    auto* fi = new FileInputSource(description, filep, close_file);
-    processInputSource(std::shared_ptr<InputSource>(fi), password);
+    processInputSource(
+        std::make_shared<is::Buffered>(
+            std::make_shared<FileInputSource>(description, filep, close_file)),
+        password);
 }
 
 void
@@ -284,6 +292,22 @@ QPDF::setPasswordIsHexKey(bool val)
     m->provided_password_is_hex_key = val;
 }
 
+void
+QPDF::setPasswordCandidates(std::vector<std::string> const& passwords)
+{
+    m->password_candidates = passwords;
+}
+
+void
+QPDF::setPasswordCandidateJobs(int jobs)
+{
+    if (jobs < 0) {
+        throw std::logic_error("QPDF::setPasswordCandidateJobs called with a negative value");
+    }
+    m->password_candidate_jobs =
+        jobs == 0 ? std::max(1U, std::thread::hardware_concurrency()) : QIntC::to_size(jobs);
+}
+
 void
 QPDF::emptyPDF()
 {
@@ -303,6 +327,22 @@ QPDF::setIgnoreXRefStreams(bool val)
     m->ignore_xref_streams = val;
 }
 
+void
+QPDF::setMmapInput(bool val)
+{
+    m->mmap_input = val;
+}
+
+void
+QPDF::setObjectStreamJobs(int jobs)
+{
+    if (jobs < 0) {
+        throw std::logic_error("QPDF::setObjectStreamJobs called with a negative value");
+    }
+    m->object_stream_jobs =
+        jobs == 0 ? std::max(1U, std::thread::hardware_concurrency()) : QIntC::to_size(jobs);
+}
+
 std::shared_ptr<QPDFLogger>
 QPDF::getLogger()
 {
@@ -413,6 +453,24 @@ QPDF::findHeader()
     return valid;
 }
 
+QPDF::Pipe::QuietWarnings::QuietWarnings(QPDF* qpdf) :
+    qpdf(qpdf),
+    n_warnings(qpdf->m->warnings.size()),
+    max_warnings(qpdf->m->max_warnings),
+    suppress_warnings(qpdf->m->suppress_warnings)
+{
+    qpdf->m->max_warnings = 0;
+    qpdf->m->suppress_warnings = true;
+}
+
+QPDF::Pipe::QuietWarnings::~QuietWarnings()
+{
+    auto& warnings = qpdf->m->warnings;
+    warnings.erase(warnings.begin() + QIntC::to_offset(n_warnings), warnings.end());
+    qpdf->m->max_warnings = max_warnings;
+    qpdf->m->suppress_warnings = suppress_warnings;
+}
+
 void
 QPDF::warn(QPDFExc const& e)
 {
@@ -573,6 +631,26 @@ QPDF::copyForeignObject(QPDFObjectHandle foreign)
     return obj_copier.object_map[foreign.getObjGen()];
 }
 
+// Return whether foreign is a dictionary of the given type as QPDFObjectHandle::isPageObject or
+// isPagesObject would. Those enumerate the pages of foreign's file, which repairs the /Type of
+// nodes in the pages tree, so copying a single page would walk the whole tree of a large file. Only
+// do that if foreign may be such a node with a missing or wrong /Type.
+static bool
+is_page_tree_node(QPDFObjectHandle& foreign, std::string const& type)
+{
+    if (!foreign.getOwningQPDF()) {
+        return false;
+    }
+    bool typed = foreign.isDictionaryOfType("/Page") ? !foreign.hasKey("/Kids")
+                                                      : foreign.isDictionaryOfType("/Pages");
+    if (!typed && foreign.isDictionary() &&
+        foreign.getKey("/Parent").isDictionaryOfType("/Pages")) {
+        QTC::TC("qpdf", "QPDF copyForeign check untyped page tree node");
+        return type == "/Page" ? foreign.isPageObject() : foreign.isPagesObject();
+    }
+    return foreign.isDictionaryOfType(type);
+}
+
 void
 QPDF::reserveObjects(QPDFObjectHandle foreign, ObjCopier& obj_copier, bool top)
 {
@@ -581,7 +659,7 @@ QPDF::reserveObjects(QPDFObjectHandle foreign, ObjCopier& obj_copier, bool top)
         throw std::logic_error("QPDF: attempting to copy a foreign reserved object");
     }
 
-    if (foreign.isPagesObject()) {
+    if (is_page_tree_node(foreign, "/Pages")) {
         QTC::TC("qpdf", "QPDF not copying pages object");
         return;
     }
@@ -594,7 +672,8 @@ QPDF::reserveObjects(QPDFObjectHandle foreign, ObjCopier& obj_copier, bool top)
         }
         if (obj_copier.object_map.count(foreign_og) > 0) {
             QTC::TC("qpdf", "QPDF already reserved object");
-            if (!(top && foreign.isPageObject() && obj_copier.object_map[foreign_og].isNull())) {
+            if (!(top && is_page_tree_node(foreign, "/Page") &&
+                  obj_copier.object_map[foreign_og].isNull())) {
                 obj_copier.visiting.erase(foreign);
                 return;
             }
@@ -602,7 +681,7 @@ QPDF::reserveObjects(QPDFObjectHandle foreign, ObjCopier& obj_copier, bool top)
             QTC::TC("qpdf", "QPDF copy indirect");
             obj_copier.object_map[foreign_og] =
                 foreign.isStream() ? newStream() : newIndirectNull();
-            if ((!top) && foreign.isPageObject()) {
+            if ((!top) && is_page_tree_node(foreign, "/Page")) {
                 QTC::TC("qpdf", "QPDF not crossing page boundary");
                 obj_copier.visiting.erase(foreign_og);
                 return;
@@ -826,18 +905,15 @@ QPDF::getRoot()
 
 std::map<QPDFObjGen, QPDFXRefEntry>
 QPDF::getXRefTable()
-{
-    return getXRefTableInternal();
-}
-
-std::map<QPDFObjGen, QPDFXRefEntry> const&
-QPDF::getXRefTableInternal()
 {
     if (!m->parsed) {
         throw std::logic_error("QPDF::getXRefTable called before parsing.");
     }
-
-    return m->xref_table;
+    std::map<QPDFObjGen, QPDFXRefEntry> result;
+    for (auto const& [og, entry]: m->xref_table) {
+        result.emplace_hint(result.end(), og, entry);
+    }
+    return result;
 }
 
 bool
@@ -860,12 +936,32 @@ QPDF::pipeStreamData(
 
     bool attempted_finish = false;
     try {
-        auto buf = file->read(length, offset);
-        if (buf.size() != length) {
-            throw damagedPDF(
-                *file, "", offset + toO(buf.size()), "unexpected EOF reading stream data");
+        // If the input is in memory, feed the pipeline directly from it without copying.
+        // Otherwise, read it in blocks so that large streams are never held in memory.
+        auto buf = is::view(*file);
+        if (!buf.empty() && offset >= 0 && QIntC::to_size(offset) <= buf.size() &&
+            length <= buf.size() - QIntC::to_size(offset)) {
+            buf = buf.substr(QIntC::to_size(offset), length);
+            file->seek(offset + toO(length), SEEK_SET);
+            file->setLastOffset(offset);
+            pipeline->write(buf.data(), length);
+        } else {
+            std::string block;
+            size_t done = 0;
+            while (done < length) {
+                auto to_read = std::min(length - done, size_t(65536));
+                if (file->read(block, to_read, offset + toO(done)) != to_read) {
+                    throw damagedPDF(
+                        *file,
+                        "",
+                        offset + toO(done + block.size()),
+                        "unexpected EOF reading stream data");
+                }
+                pipeline->write(block.data(), to_read);
+                done += to_read;
+            }
+            file->setLastOffset(offset);
         }
-        pipeline->write(buf.data(), length);
         attempted_finish = true;
         pipeline->finish();
         return true;
@@ -951,6 +1047,84 @@ QPDF::pipeForeignStreamData(
         will_retry);
 }
 
+std::optional<size_t>
+QPDF::rawStreamLength(QPDFObjectHandle& stream)
+{
+    // The raw data of a stream that was read from an unencrypted input file and whose data has not
+    // been replaced is exactly the bytes at its offset in the file.
+    auto s = stream.as_stream();
+    if (!s || m->encp->encrypted || stream.getOwningQPDF() != this || s.getStreamDataBuffer() ||
+        s.getStreamDataProvider() || stream.getParsedOffset() <= 0) {
+        return std::nullopt;
+    }
+    auto offset = stream.getParsedOffset();
+    auto length = s.getLength();
+    try {
+        m->file->seek(0, SEEK_END);
+        auto end = m->file->tell();
+        if (offset > end || length > toS(end - offset)) {
+            // Let pipeStreamData report the error.
+            return std::nullopt;
+        }
+    } catch (std::exception&) {
+        return std::nullopt;
+    }
+    return length;
+}
+
+char
+QPDF::copyRawStreamData(QPDFObjectHandle& stream, Pipeline& pipeline)
+{
+    auto offset = stream.getParsedOffset();
+    auto length = stream.as_stream().getLength();
+    if (length == 0) {
+        return '\0';
+    }
+    if (auto data = is::view(*m->file); !data.empty()) {
+        pipeline.write(data.data() + offset, length);
+        return data[toS(offset) + length - 1];
+    }
+    // Copy in large blocks rather than through the stream's pipeline machinery.
+    std::string buf(std::min(length, size_t(1) << 20), '\0');
+    m->file->seek(offset, SEEK_SET);
+    char last = '\0';
+    while (length > 0) {
+        auto len = m->file->read(buf.data(), std::min(length, buf.size()));
+        if (len == 0) {
+            throw damagedPDF(
+                *m->file, "", m->file->getLastOffset(), "unexpected EOF reading stream data");
+        }
+        pipeline.write(buf.data(), len);
+        last = buf[len - 1];
+        length -= len;
+    }
+    return last;
+}
+
+char
+QPDF::copyInputFile(Pipeline& pipeline)
+{
+    if (auto data = is::view(*m->file); !data.empty()) {
+        pipeline.write(data.data(), data.size());
+        return data.back();
+    }
+    m->file->seek(0, SEEK_END);
+    auto length = toS(m->file->tell());
+    std::string buf(std::min(length, size_t(1) << 20), '\0');
+    m->file->seek(0, SEEK_SET);
+    char last = '\0';
+    while (length > 0) {
+        auto len = m->file->read(buf.data(), std::min(length, buf.size()));
+        if (len == 0) {
+            throw damagedPDF(*m->file, "", m->file->getLastOffset(), "unexpected EOF copying file");
+        }
+        pipeline.write(buf.data(), len);
+        last = buf[len - 1];
+        length -= len;
+    }
+    return last;
+}
+
 // Throw a generic exception when we lack context for something more specific. New code should not
 // use this. This method exists to improve somewhat from calling assert in very old code.
 void
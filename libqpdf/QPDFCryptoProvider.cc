@@ -76,7 +76,7 @@ QPDFCryptoProvider::getImpl_internal(std::string const& name) const
         throw std::logic_error(
             "QPDFCryptoProvider requested unknown implementation \"" + name + "\"");
     }
-    return m->providers[name]();
+    return iter->second();
 }
 
 void
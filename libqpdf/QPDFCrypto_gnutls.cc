@@ -251,6 +251,61 @@ QPDFCrypto_gnutls::rijndael_finalize()
     }
 }
 
+void
+QPDFCrypto_gnutls::rijndael_cbc(
+    bool encrypt,
+    unsigned char const* key_data,
+    size_t key_len,
+    unsigned char const* iv,
+    unsigned char const* in_data,
+    unsigned char* out_data,
+    size_t len)
+{
+    unsigned char cbc_block[rijndael_buf_size];
+    memcpy(cbc_block, iv, rijndael_buf_size);
+    rijndael_init(encrypt, key_data, key_len, true, cbc_block);
+    int code = encrypt ? gnutls_cipher_encrypt2(this->cipher_ctx, in_data, len, out_data, len)
+                       : gnutls_cipher_decrypt2(this->cipher_ctx, in_data, len, out_data, len);
+    rijndael_finalize();
+    if (code < 0) {
+        throw std::runtime_error(
+            std::string("gnutls: AES error: ") + std::string(gnutls_strerror(code)));
+    }
+}
+
+void
+QPDFCrypto_gnutls::SHA2_batch(
+    int bits,
+    size_t count,
+    unsigned char const* const* in_data,
+    size_t const* lens,
+    unsigned char* const* out_data)
+{
+    gnutls_digest_algorithm_t alg = GNUTLS_DIG_UNKNOWN;
+    switch (bits) {
+    case 256:
+        alg = GNUTLS_DIG_SHA256;
+        break;
+    case 384:
+        alg = GNUTLS_DIG_SHA384;
+        break;
+    case 512:
+        alg = GNUTLS_DIG_SHA512;
+        break;
+    default:
+        badBits();
+        break;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int code = gnutls_hash_fast(alg, in_data[i], lens[i], out_data[i]);
+        if (code < 0) {
+            throw std::runtime_error(
+                std::string("gnutls: SHA") + std::to_string(bits) +
+                " error: " + std::string(gnutls_strerror(code)));
+        }
+    }
+}
+
 void
 QPDFCrypto_gnutls::badBits()
 {
@@ -2,6 +2,8 @@
 
 #include <qpdf/QUtil.hh>
 
+#include <cstring>
+
 #ifdef USE_INSECURE_RANDOM
 # include <qpdf/InsecureRandomDataProvider.hh>
 #endif
@@ -125,3 +127,29 @@ void
 QPDFCrypto_native::rijndael_finalize()
 {
 }
+
+void
+QPDFCrypto_native::rijndael_cbc(
+    bool encrypt,
+    unsigned char const* key_data,
+    size_t key_len,
+    unsigned char const* iv,
+    unsigned char const* in_data,
+    unsigned char* out_data,
+    size_t len)
+{
+    unsigned char cbc_block[rijndael_buf_size];
+    std::memcpy(cbc_block, iv, rijndael_buf_size);
+    AES_PDF_native(encrypt, key_data, key_len, true, cbc_block).update(in_data, out_data, len);
+}
+
+void
+QPDFCrypto_native::SHA2_batch(
+    int bits,
+    size_t count,
+    unsigned char const* const* in_data,
+    size_t const* lens,
+    unsigned char* const* out_data)
+{
+    SHA2_native::batch(bits, count, in_data, lens, out_data);
+}
@@ -1,5 +1,6 @@
 #include <qpdf/QPDFCrypto_openssl.hh>
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include <stdexcept>
@@ -256,6 +257,60 @@ QPDFCrypto_openssl::rijndael_process(unsigned char* in_data, unsigned char* out_
     check_openssl(EVP_CipherUpdate(cipher_ctx, out_data, &len, in_data, len));
 }
 
+void
+QPDFCrypto_openssl::rijndael_cbc(
+    bool encrypt,
+    unsigned char const* key_data,
+    size_t key_len,
+    unsigned char const* iv,
+    unsigned char const* in_data,
+    unsigned char* out_data,
+    size_t len)
+{
+    // EVP_CipherInit_ex copies the initialization vector.
+    rijndael_init(encrypt, key_data, key_len, true, const_cast<unsigned char*>(iv));
+    // Process in chunks in case len is too big to fit in an int.
+    static size_t const max_bytes = 1 << 30;
+    while (len > 0) {
+        size_t bytes = std::min(len, max_bytes);
+        int out_len = 0;
+        check_openssl(EVP_CipherUpdate(
+            cipher_ctx, out_data, &out_len, in_data, QIntC::to_int(bytes)));
+        in_data += bytes;
+        out_data += bytes;
+        len -= bytes;
+    }
+    rijndael_finalize();
+}
+
+void
+QPDFCrypto_openssl::SHA2_batch(
+    int bits,
+    size_t count,
+    unsigned char const* const* in_data,
+    size_t const* lens,
+    unsigned char* const* out_data)
+{
+    EVP_MD const* md = nullptr;
+    switch (bits) {
+    case 256:
+        md = EVP_sha256();
+        break;
+    case 384:
+        md = EVP_sha384();
+        break;
+    case 512:
+        md = EVP_sha512();
+        break;
+    default:
+        bad_bits(bits);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        check_openssl(EVP_Digest(in_data[i], lens[i], out_data[i], nullptr, md, nullptr));
+    }
+}
+
 void
 QPDFCrypto_openssl::RC4_finalize()
 {
@@ -1,12 +1,23 @@
+// Include qpdf-config.h first so off_t is guaranteed to have the right size.
+#include <qpdf/qpdf-config.h>
+
 #include <qpdf/QPDFJob.hh>
 
+#include <atomic>
+#include <cstdio>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef HAVE_GETRUSAGE
+# include <sys/resource.h>
+#endif
 
+#include <qpdf/BufferInputSource.hh>
 #include <qpdf/ClosedFileInputSource.hh>
 #include <qpdf/FileInputSource.hh>
-#include <qpdf/Pl_Count.hh>
 #include <qpdf/Pl_DCT.hh>
 #include <qpdf/Pl_Discard.hh>
 #include <qpdf/Pl_Flate.hh>
@@ -37,6 +48,32 @@ using namespace qpdf;
 
 namespace
 {
+    // Settings for DCT compression of optimized images.
+    struct JpegOptions
+    {
+        int quality{0};
+        Pl_DCT::subsampling_e subsampling{Pl_DCT::s_default};
+        bool optimize_huffman{false};
+        bool progressive{false};
+    };
+
+    // A temporary file, shared by the images optimized by a job, that holds optimized image data
+    // that doesn't fit in memory. The data of each image is appended to the file.
+    class SpillFile
+    {
+      public:
+        // Append data to the file and set offset to where it was written. Return false if the file
+        // can't be created or written.
+        bool append(std::string const& data, qpdf_offset_t& offset);
+        // Write length bytes starting at offset to pipeline. Return false if they can't be read.
+        bool read(qpdf_offset_t offset, size_t length, Pipeline* pipeline);
+
+      private:
+        std::unique_ptr<FILE, decltype(&fclose)> file{nullptr, &fclose};
+        qpdf_offset_t size{0};
+        bool failed{false};
+    };
+
     class ImageOptimizer: public QPDFObjectHandle::StreamDataProvider
     {
       public:
@@ -45,18 +82,85 @@ namespace
             size_t oi_min_width,
             size_t oi_min_height,
             size_t oi_min_area,
+            JpegOptions const& jpeg,
+            std::shared_ptr<SpillFile> spill_file,
             QPDFObjectHandle& image);
         ~ImageOptimizer() override = default;
         void provideStreamData(QPDFObjGen const&, Pipeline* pipeline) override;
-        std::shared_ptr<Pipeline> makePipeline(std::string const& description, Pipeline* next);
-        bool evaluate(std::string const& description);
+
+        // An image is evaluated in three steps. prepare and finish use the image's QPDF and must
+        // be called from the thread that owns it. encode, which does the DCT compression, only
+        // uses data obtained by prepare and may be called from any thread. finish reports the
+        // outcome with --verbose and returns whether the image should be replaced.
+        bool prepare();
+        void encode();
+        bool finish(std::string const& description, size_t& memory_available);
+        size_t
+        preparedSize() const
+        {
+            return raw.size();
+        }
+        // The reason for not optimizing the image, if any.
+        std::string const&
+        getNote() const
+        {
+            return note;
+        }
 
       private:
+        std::shared_ptr<Pipeline> makePipeline(Pipeline* next);
+        void keep(std::string&& encoded, size_t& memory_available);
+
         QPDFJob& o;
         size_t oi_min_width;
         size_t oi_min_height;
         size_t oi_min_area;
+        JpegOptions jpeg;
         QPDFObjectHandle image;
+        std::string note;
+        bool prepared{false};
+        JDIMENSION width{0};
+        JDIMENSION height{0};
+        int components{0};
+        J_COLOR_SPACE color_space{JCS_UNKNOWN};
+        // The decoded image data, from prepare until encode is done with it.
+        std::string raw;
+        std::string result;
+        std::exception_ptr error;
+        // The DCT-encoded image data, if the image is optimized. It is kept in memory as long as
+        // memory_available permits and otherwise written to spill_file at spill_offset. If neither
+        // is possible, the image is encoded again when the data is needed.
+        bool cached{false};
+        std::string encoded;
+        std::shared_ptr<SpillFile> spill_file;
+        bool spilled{false};
+        qpdf_offset_t spill_offset{0};
+        size_t spill_length{0};
+    };
+
+    // A pipeline that discards its input and, when finished, rethrows an exception encountered
+    // earlier while processing the same data.
+    class Rethrow final: public Pipeline
+    {
+      public:
+        Rethrow(std::exception_ptr error) :
+            Pipeline("rethrow", nullptr),
+            error(error)
+        {
+        }
+        ~Rethrow() override = default;
+        void
+        write(unsigned char const*, size_t) override
+        {
+        }
+        void
+        finish() override
+        {
+            std::rethrow_exception(error);
+        }
+
+      private:
+        std::exception_ptr error;
     };
 
     class DiscardContents: public QPDFObjectHandle::ParserCallbacks
@@ -76,12 +180,12 @@ namespace
     struct QPDFPageData
     {
         QPDFPageData(std::string const& filename, QPDF* qpdf, std::string const& range);
-        QPDFPageData(QPDFPageData const& other, int page);
+        QPDFPageData(QPDFPageData const& other, size_t i);
 
         std::string filename;
         QPDF* qpdf;
-        std::vector<QPDFObjectHandle> orig_pages;
         std::vector<int> selected_pages;
+        std::vector<QPDFObjectHandle> pages;
     };
 
     class ProgressReporter: public QPDFWriter::ProgressReporter
@@ -108,42 +212,53 @@ ImageOptimizer::ImageOptimizer(
     size_t oi_min_width,
     size_t oi_min_height,
     size_t oi_min_area,
+    JpegOptions const& jpeg,
+    std::shared_ptr<SpillFile> spill_file,
     QPDFObjectHandle& image) :
     o(o),
     oi_min_width(oi_min_width),
     oi_min_height(oi_min_height),
     oi_min_area(oi_min_area),
-    image(image)
+    jpeg(jpeg),
+    image(image),
+    spill_file(std::move(spill_file))
 {
 }
 
 std::shared_ptr<Pipeline>
-ImageOptimizer::makePipeline(std::string const& description, Pipeline* next)
+ImageOptimizer::makePipeline(Pipeline* next)
+{
+    auto dct = std::make_shared<Pl_DCT>("jpg", next, width, height, components, color_space);
+    if (jpeg.quality > 0) {
+        dct->setQuality(jpeg.quality);
+    }
+    dct->setSubsampling(jpeg.subsampling);
+    dct->setOptimizeHuffman(jpeg.optimize_huffman);
+    dct->setProgressive(jpeg.progressive);
+    return dct;
+}
+
+bool
+ImageOptimizer::prepare()
 {
-    std::shared_ptr<Pipeline> result;
+    if (!image.pipeStreamData(nullptr, 0, qpdf_dl_specialized, true)) {
+        QTC::TC("qpdf", "QPDFJob image optimize no pipeline");
+        note = "not optimizing because unable to decode data or data already uses DCT";
+        return false;
+    }
     QPDFObjectHandle dict = image.getDict();
     QPDFObjectHandle w_obj = dict.getKey("/Width");
     QPDFObjectHandle h_obj = dict.getKey("/Height");
     QPDFObjectHandle colorspace_obj = dict.getKey("/ColorSpace");
     if (!(w_obj.isNumber() && h_obj.isNumber())) {
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because image dictionary is missing required keys\n";
-            });
-        }
-        return result;
+        note = "not optimizing because image dictionary is missing required keys";
+        return false;
     }
     QPDFObjectHandle components_obj = dict.getKey("/BitsPerComponent");
     if (!(components_obj.isInteger() && (components_obj.getIntValue() == 8))) {
         QTC::TC("qpdf", "QPDFJob image optimize bits per component");
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because image has other than 8 bits per component\n";
-            });
-        }
-        return result;
+        note = "not optimizing because image has other than 8 bits per component";
+        return false;
     }
     // Files have been seen in the wild whose width and height are floating point, which is goofy,
     // but we can deal with it.
@@ -160,94 +275,167 @@ ImageOptimizer::makePipeline(std::string const& description, Pipeline* next)
         h = static_cast<JDIMENSION>(h_obj.getNumericValue());
     }
     std::string colorspace = (colorspace_obj.isName() ? colorspace_obj.getName() : std::string());
-    int components = 0;
-    J_COLOR_SPACE cs = JCS_UNKNOWN;
     if (colorspace == "/DeviceRGB") {
         components = 3;
-        cs = JCS_RGB;
+        color_space = JCS_RGB;
     } else if (colorspace == "/DeviceGray") {
         components = 1;
-        cs = JCS_GRAYSCALE;
+        color_space = JCS_GRAYSCALE;
     } else if (colorspace == "/DeviceCMYK") {
         components = 4;
-        cs = JCS_CMYK;
+        color_space = JCS_CMYK;
     } else {
         QTC::TC("qpdf", "QPDFJob image optimize colorspace");
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because qpdf can't optimize images with this colorspace\n";
-            });
-        }
-        return result;
+        note = "not optimizing because qpdf can't optimize images with this colorspace";
+        return false;
     }
     if (((this->oi_min_width > 0) && (w <= this->oi_min_width)) ||
         ((this->oi_min_height > 0) && (h <= this->oi_min_height)) ||
         ((this->oi_min_area > 0) && ((w * h) <= this->oi_min_area))) {
         QTC::TC("qpdf", "QPDFJob image optimize too small");
-        if (!description.empty()) {
-            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-                v << prefix << ": " << description
-                  << ": not optimizing because image is smaller than requested minimum "
-                     "dimensions\n";
-            });
-        }
-        return result;
+        note = "not optimizing because image is smaller than requested minimum dimensions";
+        return false;
     }
+    width = w;
+    height = h;
 
-    result = std::make_shared<Pl_DCT>("jpg", next, w, h, components, cs);
-    return result;
+    Pl_String s("decoded image", nullptr, raw);
+    if (!image.pipeStreamData(&s, 0, qpdf_dl_specialized)) {
+        raw.clear();
+        return false;
+    }
+    prepared = true;
+    return true;
 }
 
-bool
-ImageOptimizer::evaluate(std::string const& description)
+void
+ImageOptimizer::encode()
 {
-    if (!image.pipeStreamData(nullptr, 0, qpdf_dl_specialized, true)) {
-        QTC::TC("qpdf", "QPDFJob image optimize no pipeline");
-        o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-            v << prefix << ": " << description
-              << ": not optimizing because unable to decode data or data already uses DCT\n";
-        });
-        return false;
+    try {
+        Pl_String s("encoded image", nullptr, result);
+        auto p = makePipeline(&s);
+        p->writeString(raw);
+        p->finish();
+    } catch (...) {
+        error = std::current_exception();
     }
-    Pl_Discard d;
-    Pl_Count c("count", &d);
-    std::shared_ptr<Pipeline> p = makePipeline(description, &c);
-    if (p == nullptr) {
-        // message issued by makePipeline
+    raw.clear();
+    raw.shrink_to_fit();
+}
+
+bool
+ImageOptimizer::finish(std::string const& description, size_t& memory_available)
+{
+    if (!prepared) {
+        if (!note.empty()) {
+            o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": " << description << ": " << note << "\n";
+            });
+        }
         return false;
     }
-    if (!image.pipeStreamData(p.get(), 0, qpdf_dl_specialized)) {
+    if (error) {
+        // Feed the image data through the failed encoder again so that the error is handled
+        // exactly as if the image had been encoded while its data was being decoded.
+        Rethrow r(error);
+        image.pipeStreamData(&r, 0, qpdf_dl_specialized);
         return false;
     }
     long long orig_length = image.getDict().getKey("/Length").getIntValue();
-    if (c.getCount() >= orig_length) {
+    auto new_length = static_cast<long long>(result.size());
+    if (new_length >= orig_length) {
         QTC::TC("qpdf", "QPDFJob image optimize no shrink");
+        note = "not optimizing because DCT compression does not reduce image size";
         o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-            v << prefix << ": " << description
-              << ": not optimizing because DCT compression does not reduce image size\n";
+            v << prefix << ": " << description << ": " << note << "\n";
         });
+        result.clear();
+        result.shrink_to_fit();
         return false;
     }
     o.doIfVerbose([&](Pipeline& v, std::string const& prefix) {
         v << prefix << ": " << description << ": optimizing image reduces size from " << orig_length
-          << " to " << c.getCount() << "\n";
+          << " to " << new_length << "\n";
     });
+    keep(std::move(result), memory_available);
+    return true;
+}
+
+void
+ImageOptimizer::keep(std::string&& data, size_t& memory_available)
+{
+    if (data.size() <= memory_available) {
+        memory_available -= data.size();
+        encoded = std::move(data);
+        cached = true;
+        return;
+    }
+    if (spill_file->append(data, spill_offset)) {
+        QTC::TC("qpdf", "QPDFJob image optimize spill");
+        spill_length = data.size();
+        spilled = true;
+        cached = true;
+    }
+    // Otherwise, encode the image again when writing.
+}
+
+bool
+SpillFile::append(std::string const& data, qpdf_offset_t& offset)
+{
+    if (failed) {
+        return false;
+    }
+    if (!file) {
+        file.reset(std::tmpfile());
+    }
+    // Reading image data moves the file position, so always seek to the end of what was written.
+    if (file && QUtil::seek(file.get(), size, SEEK_SET) == 0 &&
+        fwrite(data.data(), 1, data.size(), file.get()) == data.size() &&
+        fflush(file.get()) == 0) {
+        offset = size;
+        size += QIntC::to_offset(data.size());
+        return true;
+    }
+    // Don't try again, but keep the file for the data already written to it.
+    failed = true;
+    return false;
+}
+
+bool
+SpillFile::read(qpdf_offset_t offset, size_t length, Pipeline* pipeline)
+{
+    if (QUtil::seek(file.get(), offset, SEEK_SET) != 0) {
+        return false;
+    }
+    char buf[65536];
+    while (length > 0) {
+        size_t len = fread(buf, 1, std::min(length, sizeof(buf)), file.get());
+        if (len == 0) {
+            return false;
+        }
+        pipeline->write(buf, len);
+        length -= len;
+    }
     return true;
 }
 
 void
 ImageOptimizer::provideStreamData(QPDFObjGen const&, Pipeline* pipeline)
 {
-    std::shared_ptr<Pipeline> p = makePipeline("", pipeline);
-    if (p == nullptr) {
-        // Should not be possible
-        image.warnIfPossible(
-            "unable to create pipeline after previous success; image data will be lost");
+    if (cached && !spilled) {
+        pipeline->write(encoded.data(), encoded.size());
         pipeline->finish();
         return;
     }
-    image.pipeStreamData(p.get(), 0, qpdf_dl_specialized, false, false);
+    if (cached) {
+        if (!spill_file->read(spill_offset, spill_length, pipeline)) {
+            image.warnIfPossible(
+                "error reading optimized image data from temporary file; image data will be lost");
+        }
+        pipeline->finish();
+        return;
+    }
+    image.pipeStreamData(makePipeline(pipeline).get(), 0, qpdf_dl_specialized, false, false);
 }
 
 QPDFJob::PageSpec::PageSpec(
@@ -262,23 +450,51 @@ QPDFJob::PageSpec::PageSpec(
 
 QPDFPageData::QPDFPageData(std::string const& filename, QPDF* qpdf, std::string const& range) :
     filename(filename),
-    qpdf(qpdf),
-    orig_pages(qpdf->getAllPages())
+    qpdf(qpdf)
 {
-    try {
-        this->selected_pages =
-            QUtil::parse_numrange(range.c_str(), QIntC::to_int(this->orig_pages.size()));
-    } catch (std::runtime_error& e) {
-        throw std::runtime_error("parsing numeric range for " + filename + ": " + e.what());
+    // Look up only the selected pages so that taking a few pages from a large file doesn't require
+    // enumerating its entire pages tree. Each lookup may have to walk through many kids of a node,
+    // so when more than a few pages are selected, enumerate the pages tree once instead.
+    static size_t constexpr max_pages_looked_up = 16;
+    auto select = [&](size_t npages) {
+        try {
+            selected_pages = QUtil::parse_numrange(range.c_str(), QIntC::to_int(npages));
+        } catch (std::runtime_error& e) {
+            throw std::runtime_error("parsing numeric range for " + filename + ": " + e.what());
+        }
+        pages.clear();
+        if (selected_pages.size() > max_pages_looked_up) {
+            QTC::TC("qpdf", "QPDFJob pages range all pages");
+            auto const& all_pages = qpdf->getAllPages();
+            for (auto pageno: selected_pages) {
+                // If the pages tree had to be repaired, the range is interpreted again below.
+                auto i = QIntC::to_size(pageno - 1);
+                pages.emplace_back(
+                    i < all_pages.size() ? all_pages.at(i) : QPDFObjectHandle::newNull());
+            }
+            return;
+        }
+        for (auto pageno: selected_pages) {
+            // Pages are specified from 1 but numbered from 0 by getPage.
+            pages.emplace_back(qpdf->getPage(QIntC::to_size(pageno - 1)));
+        }
+    };
+    auto npages = qpdf->getPageCount();
+    select(npages);
+    if (qpdf->getPageCount() != npages) {
+        // Looking up the pages found that the pages tree was damaged and had to be repaired,
+        // changing the number of pages, so the range has to be interpreted again.
+        QTC::TC("qpdf", "QPDFJob pages range after repair");
+        select(qpdf->getPageCount());
     }
 }
 
-QPDFPageData::QPDFPageData(QPDFPageData const& other, int page) :
+QPDFPageData::QPDFPageData(QPDFPageData const& other, size_t i) :
     filename(other.filename),
-    qpdf(other.qpdf),
-    orig_pages(other.orig_pages)
+    qpdf(other.qpdf)
 {
-    this->selected_pages.push_back(page);
+    selected_pages.push_back(other.selected_pages.at(i));
+    pages.push_back(other.pages.at(i));
 }
 
 void
@@ -510,6 +726,11 @@ QPDFJob::writeQPDF(QPDF& pdf)
         if (!Pl_Flate::zopfli_check_env(pdf.getLogger().get())) {
             m->warnings = true;
         }
+        // The compression level is global, so set it once here rather than for each writer, which
+        // may be created on worker threads when splitting pages.
+        if (m->compression_level >= 0) {
+            Pl_Flate::setCompressionLevel(m->compression_level);
+        }
     }
     if (!createsOutput()) {
         doInspection(pdf);
@@ -518,6 +739,15 @@ QPDFJob::writeQPDF(QPDF& pdf)
     } else {
         writeOutfile(pdf);
     }
+    doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+        size_t hits = 0;
+        size_t misses = 0;
+        QPDF::JobSetter::getObjectKeyCacheStats(pdf, hits, misses);
+        if (hits + misses > 0) {
+            v << prefix << ": object encryption keys: " << misses << " computed, " << hits
+              << " reused\n";
+        }
+    });
     if (!pdf.getWarnings().empty()) {
         m->warnings = true;
     }
@@ -535,6 +765,19 @@ QPDFJob::writeQPDF(QPDF& pdf)
         // statements from get_max_memory_usage are not interleaved with the output.
         auto mem_usage = QUtil::get_max_memory_usage();
         *m->log->getWarn() << "qpdf-max-memory-usage " << mem_usage << "\n";
+#ifdef HAVE_GETRUSAGE
+        // Peak resident set size also covers memory that malloc gets directly from the system,
+        // such as large buffers.
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+# ifdef __APPLE__
+            auto max_rss = QIntC::to_ulonglong(usage.ru_maxrss);
+# else
+            auto max_rss = QIntC::to_ulonglong(usage.ru_maxrss) * 1024;
+# endif
+            *m->log->getWarn() << "qpdf-max-rss " << max_rss << "\n";
+        }
+#endif
     }
 }
 
@@ -624,6 +867,19 @@ QPDFJob::checkConfiguration()
     if (m->check_requires_password && m->check_is_encrypted) {
         usage("--requires-password and --is-encrypted may not be given together");
     }
+    if (m->streaming_write && m->linearize) {
+        usage("--streaming-write may not be used with --linearize");
+    }
+    if (m->incremental_update) {
+        if (m->linearize || m->streaming_write || m->qdf_mode || m->split_pages) {
+            usage(
+                "--incremental-update may not be used with --linearize, --streaming-write, --qdf, "
+                "or --split-pages");
+        }
+        if (m->encrypt || m->decrypt || m->copy_encryption) {
+            usage("--incremental-update may not be used with options that change encryption");
+        }
+    }
 
     if (m->encrypt && (!m->allow_insecure) &&
         (m->owner_password.empty() && (!m->user_password.empty()) && (m->keylen == 256))) {
@@ -682,6 +938,12 @@ QPDFJob::setQPDFOptions(QPDF& pdf)
     if (m->ignore_xref_streams) {
         pdf.setIgnoreXRefStreams(true);
     }
+    if (m->mmap_input) {
+        pdf.setMmapInput(true);
+    }
+    if (m->object_stream_jobs != 1) {
+        pdf.setObjectStreamJobs(m->object_stream_jobs);
+    }
     if (m->suppress_recovery) {
         pdf.setAttemptRecovery(false);
     }
@@ -1125,7 +1387,9 @@ QPDFJob::doJSONPages(Pipeline* p, bool& first, QPDF& pdf)
 void
 QPDFJob::doJSONPageLabels(Pipeline* p, bool& first, QPDF& pdf)
 {
-    JSON j_labels = JSON::makeArray();
+    JSON::writeDictionaryKey(p, first, "pagelabels", 1);
+    bool first_label = true;
+    JSON::writeArrayOpen(p, first_label, 1);
     QPDFPageLabelDocumentHelper pldh(pdf);
     long long npages = QIntC::to_longlong(QPDFPageDocumentHelper(pdf).getAllPages().size());
     if (pldh.hasPageLabels()) {
@@ -1137,25 +1401,33 @@ QPDFJob::doJSONPageLabels(Pipeline* p, bool& first, QPDF& pdf)
                 // somehow returned an odd number of items.
                 break;
             }
-            JSON j_label = j_labels.addArrayElement(JSON::makeDictionary());
+            JSON j_label = JSON::makeDictionary();
             j_label.addDictionaryMember("index", (*iter).getJSON(m->json_version));
             ++iter;
             j_label.addDictionaryMember("label", (*iter).getJSON(m->json_version));
+            JSON::writeArrayItem(p, first_label, j_label, 2);
         }
     }
-    JSON::writeDictionaryItem(p, first, "pagelabels", j_labels, 1);
+    JSON::writeArrayClose(p, first_label, 1);
 }
 
 void
-QPDFJob::addOutlinesToJson(
-    std::vector<QPDFOutlineObjectHelper> outlines, JSON& j, std::map<QPDFObjGen, int>& page_numbers)
-{
+QPDFJob::writeOutlines(
+    Pipeline* p,
+    std::vector<QPDFOutlineObjectHelper> outlines,
+    size_t depth,
+    std::map<QPDFObjGen, int>& page_numbers)
+{
+    // Each outline is written as a dictionary with its keys in sorted order. Its kids are written
+    // as they are reached so that the outline tree never has to be held in memory as JSON.
+    bool first = true;
+    JSON::writeArrayOpen(p, first, depth);
     for (auto& ol: outlines) {
-        JSON jo = j.addArrayElement(JSON::makeDictionary());
-        jo.addDictionaryMember("object", ol.getObjectHandle().getJSON(m->json_version));
-        jo.addDictionaryMember("title", JSON::makeString(ol.getTitle()));
-        jo.addDictionaryMember("dest", ol.getDest().getJSON(m->json_version, true));
-        jo.addDictionaryMember("open", JSON::makeBool(ol.getCount() >= 0));
+        JSON::writeNext(p, first, depth + 1);
+        bool first_key = true;
+        JSON::writeDictionaryOpen(p, first_key, depth + 1);
+        JSON::writeDictionaryItem(
+            p, first_key, "dest", ol.getDest().getJSON(m->json_version, true), depth + 2);
         QPDFObjectHandle page = ol.getDestPage();
         JSON j_destpage = JSON::makeNull();
         if (page.isIndirect()) {
@@ -1164,10 +1436,18 @@ QPDFJob::addOutlinesToJson(
                 j_destpage = JSON::makeInt(page_numbers[og]);
             }
         }
-        jo.addDictionaryMember("destpageposfrom1", j_destpage);
-        JSON j_kids = jo.addDictionaryMember("kids", JSON::makeArray());
-        addOutlinesToJson(ol.getKids(), j_kids, page_numbers);
+        JSON::writeDictionaryItem(p, first_key, "destpageposfrom1", j_destpage, depth + 2);
+        JSON::writeDictionaryKey(p, first_key, "kids", depth + 2);
+        writeOutlines(p, ol.getKids(), depth + 2, page_numbers);
+        JSON::writeDictionaryItem(
+            p, first_key, "object", ol.getObjectHandle().getJSON(m->json_version), depth + 2);
+        JSON::writeDictionaryItem(
+            p, first_key, "open", JSON::makeBool(ol.getCount() >= 0), depth + 2);
+        JSON::writeDictionaryItem(
+            p, first_key, "title", JSON::makeString(ol.getTitle()), depth + 2);
+        JSON::writeDictionaryClose(p, first_key, depth + 1);
     }
+    JSON::writeArrayClose(p, first, depth);
 }
 
 void
@@ -1180,20 +1460,23 @@ QPDFJob::doJSONOutlines(Pipeline* p, bool& first, QPDF& pdf)
         page_numbers[oh.getObjGen()] = ++n;
     }
 
-    JSON j_outlines = JSON::makeArray();
     QPDFOutlineDocumentHelper odh(pdf);
-    addOutlinesToJson(odh.getTopLevelOutlines(), j_outlines, page_numbers);
-    JSON::writeDictionaryItem(p, first, "outlines", j_outlines, 1);
+    JSON::writeDictionaryKey(p, first, "outlines", 1);
+    writeOutlines(p, odh.getTopLevelOutlines(), 1, page_numbers);
 }
 
 void
 QPDFJob::doJSONAcroform(Pipeline* p, bool& first, QPDF& pdf)
 {
-    JSON j_acroform = JSON::makeDictionary();
+    // The keys of "acroform" are written in sorted order, and each field is written as soon as it
+    // has been found.
     QPDFAcroFormDocumentHelper afdh(pdf);
-    j_acroform.addDictionaryMember("hasacroform", JSON::makeBool(afdh.hasAcroForm()));
-    j_acroform.addDictionaryMember("needappearances", JSON::makeBool(afdh.getNeedAppearances()));
-    JSON j_fields = j_acroform.addDictionaryMember("fields", JSON::makeArray());
+    JSON::writeDictionaryKey(p, first, "acroform", 1);
+    bool first_key = true;
+    JSON::writeDictionaryOpen(p, first_key, 1);
+    JSON::writeDictionaryKey(p, first_key, "fields", 2);
+    bool first_field = true;
+    JSON::writeArrayOpen(p, first_field, 2);
     int pagepos1 = 0;
     for (auto const& page: QPDFPageDocumentHelper(pdf).getAllPages()) {
         ++pagepos1;
@@ -1202,7 +1485,7 @@ QPDFJob::doJSONAcroform(Pipeline* p, bool& first, QPDF& pdf)
             if (!ffh.getObjectHandle().isDictionary()) {
                 continue;
             }
-            JSON j_field = j_fields.addArrayElement(JSON::makeDictionary());
+            JSON j_field = JSON::makeDictionary();
             j_field.addDictionaryMember("object", ffh.getObjectHandle().getJSON(m->json_version));
             j_field.addDictionaryMember(
                 "parent", ffh.getObjectHandle().getKey("/Parent").getJSON(m->json_version));
@@ -1231,9 +1514,14 @@ QPDFJob::doJSONAcroform(Pipeline* p, bool& first, QPDF& pdf)
             j_annot.addDictionaryMember(
                 "appearancestate", JSON::makeString(aoh.getAppearanceState()));
             j_annot.addDictionaryMember("annotationflags", JSON::makeInt(aoh.getFlags()));
+            JSON::writeArrayItem(p, first_field, j_field, 3);
         }
     }
-    JSON::writeDictionaryItem(p, first, "acroform", j_acroform, 1);
+    JSON::writeArrayClose(p, first_field, 2);
+    JSON::writeDictionaryItem(p, first_key, "hasacroform", JSON::makeBool(afdh.hasAcroForm()), 2);
+    JSON::writeDictionaryItem(
+        p, first_key, "needappearances", JSON::makeBool(afdh.getNeedAppearances()), 2);
+    JSON::writeDictionaryClose(p, first_key, 1);
 }
 
 void
@@ -1330,12 +1618,15 @@ QPDFJob::doJSONAttachments(Pipeline* p, bool& first, QPDF& pdf)
         }
     };
 
-    JSON j_attachments = JSON::makeDictionary();
+    // Attachments are written one at a time. getEmbeddedFiles returns them in sorted order.
+    JSON::writeDictionaryKey(p, first, "attachments", 1);
+    bool first_attachment = true;
+    JSON::writeDictionaryOpen(p, first_attachment, 1);
     QPDFEmbeddedFileDocumentHelper efdh(pdf);
     for (auto const& iter: efdh.getEmbeddedFiles()) {
         std::string const& key = iter.first;
         auto fsoh = iter.second;
-        auto j_details = j_attachments.addDictionaryMember(key, JSON::makeDictionary());
+        auto j_details = JSON::makeDictionary();
         j_details.addDictionaryMember(
             "filespec", JSON::makeString(fsoh->getObjectHandle().unparse()));
         j_details.addDictionaryMember("preferredname", JSON::makeString(fsoh->getFilename()));
@@ -1361,8 +1652,9 @@ QPDFJob::doJSONAttachments(Pipeline* p, bool& first, QPDF& pdf)
             j_stream.addDictionaryMember(
                 "checksum", null_or_string(QUtil::hex_encode(efs.getChecksum())));
         }
+        JSON::writeDictionaryItem(p, first_attachment, key, j_details, 2);
     }
-    JSON::writeDictionaryItem(p, first, "attachments", j_attachments, 1);
+    JSON::writeDictionaryClose(p, first_attachment, 1);
 }
 
 JSON
@@ -1740,6 +2032,12 @@ QPDFJob::doProcessOnce(
 {
     pdf = std::make_unique<QPDF>();
     setQPDFOptions(*pdf);
+    if (main_input && !m->password_candidates.empty()) {
+        pdf->setPasswordCandidates(m->password_candidates);
+        if (m->password_candidate_jobs != 1) {
+            pdf->setPasswordCandidateJobs(m->password_candidate_jobs);
+        }
+    }
     if (empty) {
         pdf->emptyPDF();
     } else if (main_input && m->json_input) {
@@ -2171,6 +2469,127 @@ QPDFJob::copyAttachments(QPDF& pdf)
     }
 }
 
+void
+QPDFJob::optimizeImages(QPDF& pdf)
+{
+    // Images are visited in page order and evaluated in batches. For each batch, image data is
+    // decoded on this thread, DCT-encoded using up to --optimize-images-jobs threads, and then
+    // compared, reported and swapped in on this thread in the order in which images were visited.
+    struct Visit
+    {
+        QPDFObjectHandle xobj_dict;
+        std::string key;
+        std::string description;
+        std::shared_ptr<ImageOptimizer> io;
+        // For an XObject dictionary entry visited before, the index of the first visit.
+        size_t first{0};
+        bool optimized{false};
+    };
+    JpegOptions jpeg;
+    jpeg.quality = m->jpeg_quality;
+    jpeg.subsampling = static_cast<Pl_DCT::subsampling_e>(m->jpeg_subsampling);
+    jpeg.optimize_huffman = m->jpeg_optimize_huffman;
+    jpeg.progressive = m->jpeg_progressive;
+    auto spill_file = std::make_shared<SpillFile>();
+    std::vector<Visit> visits;
+    std::map<std::pair<QPDFObject*, std::string>, size_t> seen;
+    int pageno = 0;
+    for (auto& ph: QPDFPageDocumentHelper(pdf).getAllPages()) {
+        ++pageno;
+        ph.forEachImage(
+            true,
+            [this, pageno, &jpeg, &spill_file, &visits, &seen](
+                QPDFObjectHandle& obj, QPDFObjectHandle& xobj_dict, std::string const& key) {
+                auto& visit = visits.emplace_back();
+                visit.xobj_dict = xobj_dict;
+                visit.key = key;
+                visit.description = "image " + key + " on page " + std::to_string(pageno);
+                auto [it, inserted] =
+                    seen.try_emplace({xobj_dict.getObjectPtr(), key}, visits.size() - 1);
+                if (inserted) {
+                    visit.io = std::make_shared<ImageOptimizer>(
+                        *this,
+                        m->oi_min_width,
+                        m->oi_min_height,
+                        m->oi_min_area,
+                        jpeg,
+                        spill_file,
+                        obj);
+                } else {
+                    visit.first = it->second;
+                }
+            });
+    }
+
+    size_t num_jobs = QIntC::to_size(m->optimize_images_jobs);
+    if (num_jobs == 0) {
+        num_jobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+    static size_t const max_bytes_per_job = 64 * 1024 * 1024;
+    size_t const max_bytes = num_jobs * max_bytes_per_job;
+    size_t memory_available = m->oi_max_memory;
+    std::vector<ImageOptimizer*> to_encode;
+    for (size_t start = 0; start < visits.size();) {
+        size_t end = start;
+        size_t total_bytes = 0;
+        to_encode.clear();
+        for (; end < visits.size() && total_bytes < max_bytes; ++end) {
+            auto& io = visits.at(end).io;
+            if (io && io->prepare()) {
+                to_encode.emplace_back(io.get());
+                total_bytes += io->preparedSize();
+            }
+        }
+
+        QTC::TC("qpdf", "QPDFJob optimize images in parallel", to_encode.size() > 1 ? 1 : 0);
+        std::atomic<size_t> next_job{0};
+        auto worker = [&]() {
+            for (size_t i; (i = next_job++) < to_encode.size();) {
+                to_encode.at(i)->encode();
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < std::min(num_jobs, to_encode.size()); ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& t: threads) {
+            t.join();
+        }
+
+        for (; start < end; ++start) {
+            auto& visit = visits.at(start);
+            if (visit.io) {
+                visit.optimized = visit.io->finish(visit.description, memory_available);
+            } else {
+                // When an entry is visited again, it refers to the optimized image if the first
+                // visit replaced it, and otherwise to the same image with the same outcome.
+                auto& first = visits.at(visit.first);
+                std::string const& note = first.optimized
+                    ? "not optimizing because unable to decode data or data already uses DCT"
+                    : first.io->getNote();
+                if (!note.empty()) {
+                    doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                        v << prefix << ": " << visit.description << ": " << note << "\n";
+                    });
+                }
+            }
+            if (visit.optimized) {
+                auto obj = visit.xobj_dict.getKey(visit.key);
+                QPDFObjectHandle new_image = pdf.newStream();
+                new_image.replaceDict(obj.getDict().shallowCopy());
+                new_image.replaceStreamData(
+                    visit.io, QPDFObjectHandle::newName("/DCTDecode"), QPDFObjectHandle::newNull());
+                visit.xobj_dict.replaceKey(visit.key, new_image);
+                if (jpeg.progressive) {
+                    // Progressive JPEG requires PDF 1.3.
+                    m->max_input_version.updateIfGreater(PDFVersion(1, 3));
+                }
+            }
+        }
+    }
+}
+
 void
 QPDFJob::handleTransformations(QPDF& pdf)
 {
@@ -2191,26 +2610,7 @@ QPDFJob::handleTransformations(QPDF& pdf)
         }
     }
     if (m->optimize_images) {
-        int pageno = 0;
-        for (auto& ph: dh.getAllPages()) {
-            ++pageno;
-            ph.forEachImage(
-                true,
-                [this, pageno, &pdf](
-                    QPDFObjectHandle& obj, QPDFObjectHandle& xobj_dict, std::string const& key) {
-                    auto io = std::make_unique<ImageOptimizer>(
-                        *this, m->oi_min_width, m->oi_min_height, m->oi_min_area, obj);
-                    if (io->evaluate("image " + key + " on page " + std::to_string(pageno))) {
-                        QPDFObjectHandle new_image = pdf.newStream();
-                        new_image.replaceDict(obj.getDict().shallowCopy());
-                        new_image.replaceStreamData(
-                            std::move(io),
-                            QPDFObjectHandle::newName("/DCTDecode"),
-                            QPDFObjectHandle::newNull());
-                        xobj_dict.replaceKey(key, new_image);
-                    }
-                });
-        }
+        optimizeImages(pdf);
     }
     if (m->generate_appearances) {
         make_afdh();
@@ -2470,9 +2870,15 @@ QPDFJob::handlePageSpecs(QPDF& pdf, std::vector<std::unique_ptr<QPDF>>& page_hea
         }
 
         // Read original pages from the PDF, and parse the page range associated with this
-        // occurrence of the file.
-        parsed_specs.emplace_back(
-            page_spec.filename, page_spec_qpdfs[page_spec.filename], page_spec.range);
+        // occurrence of the file. Pages from other files are looked up individually, but all pages
+        // of the primary input are removed below anyway, so enumerate them now. That way any
+        // repairs to its pages tree, such as resolving duplicated pages, are done before pages are
+        // selected.
+        auto qpdf = page_spec_qpdfs[page_spec.filename];
+        if (qpdf == &pdf) {
+            (void)pdf.getAllPages();
+        }
+        parsed_specs.emplace_back(page_spec.filename, qpdf, page_spec.range);
     }
 
     std::map<unsigned long long, bool> remove_unreferenced;
@@ -2532,8 +2938,7 @@ QPDFJob::handlePageSpecs(QPDF& pdf, std::vector<std::unique_ptr<QPDF>>& page_hea
                 for (size_t j = 0; j < m->collate.at(i); ++j) {
                     if (cur_page.at(i) + j < page_data.selected_pages.size()) {
                         got_pages = true;
-                        new_parsed_specs.emplace_back(
-                            page_data, page_data.selected_pages.at(cur_page.at(i) + j));
+                        new_parsed_specs.emplace_back(page_data, cur_page.at(i) + j);
                     }
                 }
                 cur_page.at(i) += m->collate.at(i);
@@ -2565,11 +2970,11 @@ QPDFJob::handlePageSpecs(QPDF& pdf, std::vector<std::unique_ptr<QPDF>>& page_hea
         doIfVerbose([&](Pipeline& v, std::string const& prefix) {
             v << prefix << ": adding pages from " << page_data.filename << "\n";
         });
-        for (auto pageno_iter: page_data.selected_pages) {
-            // Pages are specified from 1 but numbered from 0 in the vector
-            int pageno = pageno_iter - 1;
+        for (size_t i = 0; i < page_data.selected_pages.size(); ++i) {
+            // Pages are specified from 1 but numbered from 0 by getPage
+            int pageno = page_data.selected_pages.at(i) - 1;
             pldh.getLabelsForPageRange(pageno, pageno, out_pageno++, new_labels);
-            QPDFPageObjectHelper to_copy = page_data.orig_pages.at(QIntC::to_size(pageno));
+            QPDFPageObjectHelper to_copy = page_data.pages.at(i);
             QPDFObjGen to_copy_og = to_copy.getObjectHandle().getObjGen();
             unsigned long long from_uuid = page_data.qpdf->getUniqueId();
             if (copied_pages[from_uuid].count(to_copy_og)) {
@@ -2884,9 +3289,6 @@ parse_version(std::string const& full_version_string, std::string& version, int&
 void
 QPDFJob::setWriterOptions(QPDFWriter& w)
 {
-    if (m->compression_level >= 0) {
-        Pl_Flate::setCompressionLevel(m->compression_level);
-    }
     if (m->qdf_mode) {
         w.setQDFMode(true);
     }
@@ -2908,6 +3310,9 @@ QPDFJob::setWriterOptions(QPDFWriter& w)
     if (m->recompress_flate_set) {
         w.setRecompressFlate(m->recompress_flate);
     }
+    if (m->compression_jobs != 1) {
+        w.setCompressionJobs(m->compression_jobs);
+    }
     if (m->decode_level_set) {
         w.setDecodeLevel(m->decode_level);
     }
@@ -2945,6 +3350,12 @@ QPDFJob::setWriterOptions(QPDFWriter& w)
     if (!m->linearize_pass1.empty()) {
         w.setLinearizationPass1Filename(m->linearize_pass1);
     }
+    if (m->streaming_write) {
+        w.setStreamingMode(true);
+    }
+    if (m->incremental_update) {
+        w.setIncrementalUpdate(true);
+    }
     if (m->object_stream_set) {
         w.setObjectStreamMode(m->object_stream_mode);
     }
@@ -3002,18 +3413,28 @@ QPDFJob::doSplitPages(QPDF& pdf)
         QPDFPageDocumentHelper dh(pdf);
         dh.removeUnreferencedResources();
     }
-    QPDFPageLabelDocumentHelper pldh(pdf);
-    QPDFAcroFormDocumentHelper afdh(pdf);
-    std::vector<QPDFObjectHandle> const& pages = pdf.getAllPages();
-    size_t pageno_len = std::to_string(pages.size()).length();
-    size_t num_pages = pages.size();
-    for (size_t i = 0; i < num_pages; i += QIntC::to_size(m->split_pages)) {
-        size_t first = i + 1;
-        size_t last = i + QIntC::to_size(m->split_pages);
-        if (last > num_pages) {
-            last = num_pages;
-        }
+    size_t num_pages = pdf.getAllPages().size();
+    size_t pageno_len = std::to_string(num_pages).length();
+    size_t group_size = QIntC::to_size(m->split_pages);
+
+    // Serializes access to the job's members and logger when chunks are written by more than one
+    // thread. Locking is uncontended when writing serially.
+    std::mutex job_mutex;
+    std::atomic<bool> any_warnings{false};
+
+    // Write pages first through last of in to a new file and return its name. This is used for
+    // both serial and parallel writing so that the output files are the same either way.
+    auto write_chunk = [&](QPDF& in,
+                           QPDFPageLabelDocumentHelper& pldh,
+                           QPDFAcroFormDocumentHelper& afdh,
+                           size_t first,
+                           size_t last,
+                           std::shared_ptr<QPDFLogger> log) {
+        std::vector<QPDFObjectHandle> const& pages = in.getAllPages();
         QPDF outpdf;
+        if (log) {
+            outpdf.setLogger(log);
+        }
         outpdf.emptyPDF();
         std::shared_ptr<QPDFAcroFormDocumentHelper> out_afdh;
         if (afdh.hasAcroForm()) {
@@ -3031,7 +3452,7 @@ QPDFJob::doSplitPages(QPDF& pdf)
                 try {
                     out_afdh->fixCopiedAnnotations(new_page, page, afdh);
                 } catch (std::exception& e) {
-                    pdf.warn(
+                    in.warn(
                         qpdf_e_damaged_pdf,
                         "",
                         0,
@@ -3058,10 +3479,148 @@ QPDFJob::doSplitPages(QPDF& pdf)
             throw std::runtime_error("split pages would overwrite input file with " + outfile);
         }
         QPDFWriter w(outpdf, outfile.c_str());
-        setWriterOptions(w);
+        {
+            std::lock_guard<std::mutex> lock(job_mutex);
+            setWriterOptions(w);
+        }
         w.write();
+        if (log && outpdf.anyWarnings()) {
+            // When writing in parallel, stream data is read through outpdf rather than through
+            // pdf, so problems with it are reported by outpdf.
+            any_warnings = true;
+        }
+        return outfile;
+    };
+
+    size_t num_chunks = (num_pages + group_size - 1) / group_size;
+    size_t num_jobs = QIntC::to_size(m->split_pages_jobs);
+    if (num_jobs == 0) {
+        num_jobs = std::max(1U, std::thread::hardware_concurrency());
+    }
+    num_jobs = std::min(num_jobs, num_chunks);
+    if (num_jobs > 1 &&
+        ((m->qdf_mode && !m->suppress_original_object_id) || m->preserve_unreferenced_objects)) {
+        // Copying from the snapshot described below assigns the same relative order to objects in
+        // each output file as copying from pdf, but not necessarily the same object numbers, and
+        // some indirect objects from pdf (such as stream lengths) are direct in the snapshot. Object
+        // numbers are visible in QDF comments, and preserving unreferenced objects would write the
+        // extra objects, so write serially in those cases.
+        QTC::TC("qpdf", "QPDFJob split-pages parallel not possible");
+        num_jobs = 1;
+    }
+
+    if (num_jobs <= 1) {
+        QPDFPageLabelDocumentHelper pldh(pdf);
+        QPDFAcroFormDocumentHelper afdh(pdf);
+        for (size_t i = 0; i < num_pages; i += group_size) {
+            auto outfile =
+                write_chunk(pdf, pldh, afdh, i + 1, std::min(i + group_size, num_pages), nullptr);
+            doIfVerbose([&](Pipeline& v, std::string const& prefix) {
+                v << prefix << ": wrote file " << outfile << "\n";
+            });
+        }
+        return;
+    }
+
+    // A QPDF object can't be used by more than one thread, so take an in-memory snapshot of the
+    // (possibly transformed) input with stream data left as is, and let each worker read its own
+    // QPDF from it through its own input source. With the exceptions handled above, writing pages
+    // copied from the snapshot gives the same bytes as writing them from pdf directly. The snapshot
+    // is held alongside pdf until all files are written; the cost is documented with
+    // --split-pages-jobs in the manual.
+    QTC::TC("qpdf", "QPDFJob split-pages parallel");
+    std::shared_ptr<Buffer> snapshot;
+    {
+        QPDFWriter w(pdf);
+        w.setOutputMemory();
+        w.setPreserveEncryption(false);
+        w.setObjectStreamMode(qpdf_o_disable);
+        w.setCompressStreams(false);
+        w.setDecodeLevel(qpdf_dl_none);
+        w.setStaticID(true);
+        w.write();
+        snapshot = w.getBufferSharedPointer();
+    }
+
+    struct chunk_result
+    {
+        std::string outfile;
+        std::string messages;
+        std::exception_ptr error;
+    };
+    std::vector<chunk_result> results(num_chunks);
+    std::atomic<size_t> next_chunk{0};
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        // Warnings are collected per chunk and replayed in page order once all workers are done.
+        std::string messages;
+        auto log = QPDFLogger::create();
+        log->setWarn(std::make_shared<Pl_String>("split pages warnings", nullptr, messages));
+        std::unique_ptr<QPDF> in;
+        std::unique_ptr<QPDFPageLabelDocumentHelper> pldh;
+        std::unique_ptr<QPDFAcroFormDocumentHelper> afdh;
+        while (!failed) {
+            size_t chunk = next_chunk++;
+            if (chunk >= num_chunks) {
+                break;
+            }
+            auto& result = results.at(chunk);
+            try {
+                if (!in) {
+                    in = std::make_unique<QPDF>();
+                    {
+                        std::lock_guard<std::mutex> lock(job_mutex);
+                        setQPDFOptions(*in);
+                    }
+                    in->setLogger(log);
+                    in->processInputSource(
+                        std::make_shared<BufferInputSource>(m->infilename.get(), snapshot.get()));
+                    pldh = std::make_unique<QPDFPageLabelDocumentHelper>(*in);
+                    afdh = std::make_unique<QPDFAcroFormDocumentHelper>(*in);
+                }
+                size_t first = chunk * group_size + 1;
+                result.outfile = write_chunk(
+                    *in, *pldh, *afdh, first, std::min(first + group_size - 1, num_pages), log);
+            } catch (...) {
+                result.error = std::current_exception();
+                failed = true;
+            }
+            result.messages = std::move(messages);
+            messages.clear();
+        }
+        if (in && in->anyWarnings()) {
+            any_warnings = true;
+        }
+    };
+
+    // Progress reporters write to the job's logger while writing, so they are not used for the
+    // individual files.
+    bool progress = m->progress;
+    m->progress = false;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_jobs; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& t: threads) {
+        t.join();
+    }
+    m->progress = progress;
+    if (any_warnings) {
+        m->warnings = true;
+    }
+
+    for (auto& result: results) {
+        *m->log->getWarn() << result.messages;
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+        if (result.outfile.empty()) {
+            // Not reached by any worker because an earlier chunk failed.
+            break;
+        }
         doIfVerbose([&](Pipeline& v, std::string const& prefix) {
-            v << prefix << ": wrote file " << outfile << "\n";
+            v << prefix << ": wrote file " << result.outfile << "\n";
         });
     }
 }
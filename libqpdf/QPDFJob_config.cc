@@ -2,6 +2,7 @@
 
 #include <regex>
 
+#include <qpdf/Pl_DCT.hh>
 #include <qpdf/QPDFLogger.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
@@ -132,6 +133,17 @@ QPDFJob::Config::compressStreams(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::compressionJobs(std::string const& parameter)
+{
+    int n = QUtil::string_to_int(parameter.c_str());
+    if (n < 0) {
+        usage("--compression-jobs must be a non-negative number");
+    }
+    o.m->compression_jobs = n;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::compressionLevel(std::string const& parameter)
 {
@@ -228,6 +240,24 @@ QPDFJob::Config::ignoreXrefStreams()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::mmapInput()
+{
+    o.m->mmap_input = true;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::objectStreamJobs(std::string const& parameter)
+{
+    int n = QUtil::string_to_int(parameter.c_str());
+    if (n < 0) {
+        usage("--object-stream-jobs must be a non-negative number");
+    }
+    o.m->object_stream_jobs = n;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::iiMinBytes(std::string const& parameter)
 {
@@ -235,6 +265,13 @@ QPDFJob::Config::iiMinBytes(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::incrementalUpdate()
+{
+    o.m->incremental_update = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::isEncrypted()
 {
@@ -243,6 +280,46 @@ QPDFJob::Config::isEncrypted()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::jpegOptimizeHuffman()
+{
+    o.m->jpeg_optimize_huffman = true;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::jpegProgressive()
+{
+    o.m->jpeg_progressive = true;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::jpegQuality(std::string const& parameter)
+{
+    int n = QUtil::string_to_int(parameter.c_str());
+    if (n < 1 || n > 100) {
+        usage("--jpeg-quality must be between 1 and 100");
+    }
+    o.m->jpeg_quality = n;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::jpegSubsampling(std::string const& parameter)
+{
+    if (parameter == "444") {
+        o.m->jpeg_subsampling = Pl_DCT::s_444;
+    } else if (parameter == "422") {
+        o.m->jpeg_subsampling = Pl_DCT::s_422;
+    } else if (parameter == "420") {
+        o.m->jpeg_subsampling = Pl_DCT::s_420;
+    } else {
+        usage("invalid chroma subsampling");
+    }
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::json()
 {
@@ -418,6 +495,22 @@ QPDFJob::Config::normalizeContent(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::oiMaxMemory(std::string const& parameter)
+{
+    static std::regex number_re(R"(^\d+$)");
+    try {
+        if (std::regex_match(parameter, number_re)) {
+            o.m->oi_max_memory = QIntC::to_size(QUtil::string_to_ull(parameter.c_str()));
+            return this;
+        }
+    } catch (std::exception&) {
+        // Out of range; fall through
+    }
+    usage("--oi-max-memory must be a non-negative number of bytes that fits in memory");
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::oiMinArea(std::string const& parameter)
 {
@@ -453,6 +546,17 @@ QPDFJob::Config::password(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::optimizeImagesJobs(std::string const& parameter)
+{
+    int n = QUtil::string_to_int(parameter.c_str());
+    if (n < 0) {
+        usage("--optimize-images-jobs must be a non-negative number");
+    }
+    o.m->optimize_images_jobs = n;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::passwordIsHexKey()
 {
@@ -629,6 +733,17 @@ QPDFJob::Config::splitPages(std::string const& parameter)
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::splitPagesJobs(std::string const& parameter)
+{
+    int n = QUtil::string_to_int(parameter.c_str());
+    if (n < 0) {
+        usage("--split-pages-jobs must be a non-negative number");
+    }
+    o.m->split_pages_jobs = n;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::staticAesIv()
 {
@@ -643,6 +758,13 @@ QPDFJob::Config::staticId()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::streamingWrite()
+{
+    o.m->streaming_write = true;
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::suppressPasswordRecovery()
 {
@@ -678,6 +800,30 @@ QPDFJob::Config::withImages()
     return this;
 }
 
+QPDFJob::Config*
+QPDFJob::Config::passwordCandidateJobs(std::string const& parameter)
+{
+    int n = QUtil::string_to_int(parameter.c_str());
+    if (n < 0) {
+        usage("--password-candidate-jobs must be a non-negative number");
+    }
+    o.m->password_candidate_jobs = n;
+    return this;
+}
+
+QPDFJob::Config*
+QPDFJob::Config::passwordCandidates(std::string const& parameter)
+{
+    std::list<std::string> lines;
+    if (parameter == "-") {
+        lines = QUtil::read_lines_from_file(std::cin);
+    } else {
+        lines = QUtil::read_lines_from_file(parameter.c_str());
+    }
+    o.m->password_candidates.insert(o.m->password_candidates.end(), lines.begin(), lines.end());
+    return this;
+}
+
 QPDFJob::Config*
 QPDFJob::Config::passwordFile(std::string const& parameter)
 {
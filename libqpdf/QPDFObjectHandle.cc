@@ -2,7 +2,11 @@
 
 #include <qpdf/BufferInputSource.hh>
 #include <qpdf/JSON_writer.hh>
+#include <qpdf/Pl_Bounded.hh>
 #include <qpdf/Pl_Buffer.hh>
+#include <qpdf/Pl_Concatenate.hh>
+#include <qpdf/Pl_ContentParser.hh>
+#include <qpdf/Pl_Count.hh>
 #include <qpdf/Pl_QPDFTokenizer.hh>
 #include <qpdf/QPDF.hh>
 #include <qpdf/QPDFExc.hh>
@@ -148,6 +152,19 @@ QPDFObjectHandle::TokenFilter::writeToken(QPDFTokenizer::Token const& token)
     write(value.c_str(), value.length());
 }
 
+void
+QPDFObjectHandle::TokenViewFilter::handleToken(QPDFTokenizer::Token const& token)
+{
+    handleToken(QPDFTokenizer::TokenView(token));
+}
+
+void
+QPDFObjectHandle::TokenViewFilter::writeToken(QPDFTokenizer::TokenView const& token)
+{
+    auto value = token.getRawValue();
+    write(value.data(), value.size());
+}
+
 void
 QPDFObjectHandle::ParserCallbacks::handleObject(QPDFObjectHandle)
 {
@@ -1530,12 +1547,14 @@ QPDFObjectHandle::pipeContentStreams(
     std::vector<QPDFObjectHandle> streams =
         arrayOrStreamToStreamArray(description, all_description);
     bool need_newline = false;
-    Pl_Buffer buf("concatenated content stream buffer");
+    // Pass the data through as it is decoded rather than collecting it first so that the contents
+    // never have to be in memory all at once.
+    Pl_Concatenate concat("concatenated content streams", p);
     for (auto stream: streams) {
         if (need_newline) {
-            buf.writeCStr("\n");
+            concat.writeCStr("\n");
         }
-        LastChar lc(buf);
+        LastChar lc(concat);
         if (!stream.pipeStreamData(&lc, 0, qpdf_dl_specialized)) {
             QTC::TC("qpdf", "QPDFObjectHandle errors in parsecontent");
             throw QPDFExc(
@@ -1549,8 +1568,7 @@ QPDFObjectHandle::pipeContentStreams(
         need_newline = (lc.getLastChar() != static_cast<unsigned char>('\n'));
         QTC::TC("qpdf", "QPDFObjectHandle need_newline", need_newline ? 0 : 1);
     }
-    p->writeString(buf.getString());
-    p->finish();
+    concat.manualFinish();
 }
 
 void
@@ -1593,13 +1611,25 @@ void
 QPDFObjectHandle::parseContentStream_internal(
     std::string const& description, ParserCallbacks* callbacks)
 {
-    Pl_Buffer buf("concatenated stream data buffer");
+    // Decode the contents to find their size and to make sure that they can be decoded before any
+    // callbacks are called. Unless they are very large, keep them and parse them from memory.
+    // Otherwise, decode them again, parsing them as they arrive, so that they don't have to be
+    // held in memory as a whole.
+    static size_t const max_kept = 4 * 1024 * 1024;
     std::string all_description;
-    pipeContentStreams(&buf, description, all_description);
-    auto stream_data = buf.getBufferSharedPointer();
-    callbacks->contentSize(stream_data->getSize());
+    Pl_Bounded bounded("content stream data", max_kept);
+    Pl_Count count("content stream size", &bounded);
+    pipeContentStreams(&count, description, all_description);
+    callbacks->contentSize(QIntC::to_size(count.getCount()));
+    Pl_ContentParser parser("content stream parser", all_description, callbacks, getOwningQPDF());
     try {
-        parseContentStream_data(stream_data, all_description, callbacks, getOwningQPDF());
+        if (bounded.fits()) {
+            parser.writeString(bounded.getString());
+            parser.finish();
+        } else {
+            pipeContentStreams(&parser, description, all_description);
+        }
+        parser.rethrow();
     } catch (TerminateParsing&) {
         return;
     }
@@ -1613,54 +1643,10 @@ QPDFObjectHandle::parseContentStream_data(
     ParserCallbacks* callbacks,
     QPDF* context)
 {
-    size_t stream_length = stream_data->getSize();
-    auto input = BufferInputSource(description, stream_data.get());
-    Tokenizer tokenizer;
-    tokenizer.allowEOF();
-    auto sp_description = QPDFParser::make_description(description, "content");
-    while (QIntC::to_size(input.tell()) < stream_length) {
-        // Read a token and seek to the beginning. The offset we get from this process is the
-        // beginning of the next non-ignorable (space, comment) token. This way, the offset and
-        // don't including ignorable content.
-        tokenizer.nextToken(input, "content", true);
-        qpdf_offset_t offset = input.getLastOffset();
-        input.seek(offset, SEEK_SET);
-        auto obj = QPDFParser::parse_content(input, sp_description, tokenizer, context);
-        if (!obj) {
-            // EOF
-            break;
-        }
-        size_t length = QIntC::to_size(input.tell() - offset);
-
-        callbacks->handleObject(obj, QIntC::to_size(offset), length);
-        if (obj.isOperator() && (obj.getOperatorValue() == "ID")) {
-            // Discard next character; it is the space after ID that terminated the token.  Read
-            // until end of inline image.
-            char ch;
-            input.read(&ch, 1);
-            tokenizer.expectInlineImage(input);
-            tokenizer.nextToken(input, description);
-            offset = input.getLastOffset();
-            length = QIntC::to_size(input.tell() - offset);
-            if (tokenizer.getType() == QPDFTokenizer::tt_bad) {
-                QTC::TC("qpdf", "QPDFObjectHandle EOF in inline image");
-                warn(
-                    context,
-                    QPDFExc(
-                        qpdf_e_damaged_pdf,
-                        description,
-                        "stream data",
-                        input.tell(),
-                        "EOF found while reading inline image"));
-            } else {
-                QTC::TC("qpdf", "QPDFObjectHandle inline image token");
-                callbacks->handleObject(
-                    QPDFObjectHandle::newInlineImage(tokenizer.getValue()),
-                    QIntC::to_size(offset),
-                    length);
-            }
-        }
-    }
+    Pl_ContentParser parser("content stream parser", description, callbacks, context);
+    parser.write(stream_data->getBuffer(), stream_data->getSize());
+    parser.finish();
+    parser.rethrow();
 }
 
 void
@@ -37,12 +37,15 @@ QPDFParser::parse_content(
     InputSource& input,
     std::shared_ptr<QPDFObject::Description> sp_description,
     qpdf::Tokenizer& tokenizer,
-    QPDF* context)
+    QPDF* context,
+    std::vector<QPDFExc>* warnings)
 {
     bool empty = false;
-    return QPDFParser(
-               input, std::move(sp_description), "content", tokenizer, nullptr, context, true)
-        .parse(empty, true);
+    std::string const object_description = "content";
+    QPDFParser parser(
+        input, std::move(sp_description), object_description, tokenizer, nullptr, context, true);
+    parser.warnings = warnings;
+    return parser.parse(empty, true);
 }
 
 QPDFObjectHandle
@@ -305,8 +308,8 @@ QPDFParser::parseRemainder(bool content_stream)
             }
             if (frame->state == st_array) {
                 auto object = frame->null_count > 100
-                    ? QPDFObject::create<QPDF_Array>(std::move(frame->olist), true)
-                    : QPDFObject::create<QPDF_Array>(std::move(frame->olist));
+                    ? create<QPDF_Array>(std::move(frame->olist), true)
+                    : create<QPDF_Array>(std::move(frame->olist));
                 setDescription(object, frame->offset - 1);
                 // The `offset` points to the next of "[".  Set the rewind offset to point to the
                 // beginning of "[". This has been explicitly tested with whitespace surrounding the
@@ -356,7 +359,7 @@ QPDFParser::parseRemainder(bool content_stream)
                     dict["/Contents"] = QPDFObjectHandle::newString(frame->contents_string);
                     dict["/Contents"].setParsedOffset(frame->contents_offset);
                 }
-                auto object = QPDFObject::create<QPDF_Dictionary>(std::move(dict));
+                auto object = create<QPDF_Dictionary>(std::move(dict));
                 setDescription(object, frame->offset - 2);
                 // The `offset` points to the next of "<<". Set the rewind offset to point to the
                 // beginning of "<<". This has been explicitly tested with whitespace surrounding
@@ -505,7 +508,7 @@ QPDFParser::addNull()
 void
 QPDFParser::addInt(int count)
 {
-    auto obj = QPDFObject::create<QPDF_Integer>(int_buffer[count % 2]);
+    auto obj = create<QPDF_Integer>(int_buffer[count % 2]);
     obj->setDescription(context, description, last_offset_buffer[count % 2]);
     add(std::move(obj));
 }
@@ -520,7 +523,7 @@ QPDFParser::addScalar(Args&&... args)
         max_bad_count = 0;
         return;
     }
-    auto obj = QPDFObject::create<T>(std::forward<Args>(args)...);
+    auto obj = create<T>(std::forward<Args>(args)...);
     obj->setDescription(context, description, input.getLastOffset());
     add(std::move(obj));
 }
@@ -529,7 +532,7 @@ template <typename T, typename... Args>
 QPDFObjectHandle
 QPDFParser::withDescription(Args&&... args)
 {
-    auto obj = QPDFObject::create<T>(std::forward<Args>(args)...);
+    auto obj = create<T>(std::forward<Args>(args)...);
     obj->setDescription(context, description, start);
     return {obj};
 }
@@ -599,7 +602,9 @@ QPDFParser::warn(QPDFExc const& e) const
     // If parsing on behalf of a QPDF object and want to give a warning, we can warn through the
     // object. If parsing for some other reason, such as an explicit creation of an object from a
     // string, then just throw the exception.
-    if (context) {
+    if (warnings) {
+        warnings->emplace_back(e);
+    } else if (context) {
         context->warn(e);
     } else {
         throw e;
@@ -3,6 +3,7 @@
 // DO NOT USE ctype -- it is locale dependent for some things, and it's not worth the risk of
 // including it in case it may accidentally be used.
 
+#include <qpdf/CharScan.hh>
 #include <qpdf/InputSource_private.hh>
 #include <qpdf/QIntC.hh>
 #include <qpdf/QPDFExc.hh>
@@ -11,6 +12,7 @@
 #include <qpdf/QUtil.hh>
 #include <qpdf/Util.hh>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <stdexcept>
@@ -978,17 +980,88 @@ Tokenizer::readToken(InputSource& input, std::string const& context, bool allow_
     return token;
 }
 
+size_t
+Tokenizer::scanRun(std::string_view data, size_t pos)
+{
+    // Return the end of the run of characters starting at pos that handleCharacter would consume
+    // without changing state or doing anything other than appending them to the token.
+    switch (state) {
+    case st_before_token:
+        return include_ignorable ? pos : scan::skip_space(data, pos);
+
+    case st_in_space:
+        return scan::skip_space(data, pos);
+
+    case st_in_comment:
+        return scan::find_eol(data, pos);
+
+    case st_name:
+        return scan::find_name_special(data, pos);
+
+    case st_number:
+    case st_real:
+        return scan::skip_digits(data, pos);
+
+    case st_literal:
+        return scan::find_delimiter(data, pos);
+
+    case st_in_string:
+        return scan::find_string_special(data, pos);
+
+    default:
+        return pos;
+    }
+}
+
 bool
 Tokenizer::nextToken(InputSource& input, std::string const& context, size_t max_len)
 {
     if (state != st_inline_image) {
         reset();
     }
-    qpdf_offset_t offset = input.fastTell();
+    // Work through the input a block at a time. If the input is available in memory, the block is
+    // the rest of the input. If it is an is::Buffered, the block is the rest of its buffer.
+    // Otherwise it is the contents of the input source's read buffer.
+    qpdf_offset_t data_start = 0;
+    auto const data = qpdf::is::view(input, data_start);
+    auto* const buffered = qpdf::is::buffered(input);
+    bool const direct = !data.empty() || buffered;
+    qpdf_offset_t offset = direct ? input.tell() : input.fastTell();
+    qpdf_offset_t block_start = offset;
+    std::string_view block;
+    size_t idx = 0;
+    bool first_block = true;
+    auto next_block = [&]() {
+        if (direct) {
+            block_start += QIntC::to_offset(idx);
+            if (buffered) {
+                block = buffered->window(block_start);
+                if (block.empty()) {
+                    // As with a read at EOF, leave the position at the end of the input.
+                    buffered->seek(0, SEEK_END);
+                    block_start = buffered->tell();
+                }
+            } else {
+                block = block_start >= data_start &&
+                        QIntC::to_size(block_start - data_start) < data.size()
+                    ? data.substr(QIntC::to_size(block_start - data_start))
+                    : std::string_view();
+            }
+        } else {
+            if (!first_block) {
+                input.fastAdvance(block.size());
+            }
+            block = input.fastWindow();
+            block_start = input.getLastOffset();
+        }
+        first_block = false;
+        idx = 0;
+        return !block.empty();
+    };
 
     while (state != st_token_ready) {
-        char ch;
-        if (!input.fastRead(ch)) {
+        if (idx == block.size() && !next_block()) {
+            input.setLastOffset(block_start);
             presentEOF();
 
             if ((type == tt::tt_eof) && (!allow_eof)) {
@@ -998,25 +1071,53 @@ Tokenizer::nextToken(InputSource& input, std::string const& context, size_t max_
                 error_message = "unexpected EOF";
                 offset = input.getLastOffset();
             }
-        } else {
-            handleCharacter(ch);
+            continue;
+        }
+
+        // Consume any characters that would not change the state in one step.
+        if (auto const end = scanRun(block, idx); end > idx) {
+            auto n = end - idx;
+            if (in_token && max_len) {
+                // Leave the character that reaches max_len to the code below.
+                n = std::min(n, raw_val.size() + 1 < max_len ? max_len - raw_val.size() - 1 : 0);
+            }
+            auto run = block.substr(idx, n);
+            if (state == st_name || state == st_in_string) {
+                val += run;
+            }
             if (before_token) {
-                ++offset;
+                offset += QIntC::to_offset(n);
             }
             if (in_token) {
-                raw_val += ch;
+                raw_val += run;
             }
-            if (max_len && (raw_val.length() >= max_len) && (state != st_token_ready)) {
-                // terminate this token now
-                QTC::TC("qpdf", "QPDFTokenizer block long token");
-                type = tt::tt_bad;
-                state = st_token_ready;
-                error_message = "exceeded allowable length while reading token";
+            idx += n;
+            if (idx == block.size()) {
+                continue;
             }
         }
+
+        char ch = block[idx++];
+        handleCharacter(ch);
+        if (before_token) {
+            ++offset;
+        }
+        if (in_token) {
+            raw_val += ch;
+        }
+        if (max_len && (raw_val.length() >= max_len) && (state != st_token_ready)) {
+            // terminate this token now
+            QTC::TC("qpdf", "QPDFTokenizer block long token");
+            type = tt::tt_bad;
+            state = st_token_ready;
+            error_message = "exceeded allowable length while reading token";
+        }
     }
 
-    input.fastUnread(!in_token && !before_token);
+    // Leave the input positioned after the last character consumed.
+    auto const pos = block_start + QIntC::to_offset(idx) - (!in_token && !before_token ? 1 : 0);
+    input.seek(pos, SEEK_SET);
+    input.setLastOffset(pos);
 
     if (type != tt::tt_eof) {
         input.setLastOffset(offset);
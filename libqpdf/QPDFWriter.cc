@@ -21,8 +21,12 @@
 #include <qpdf/RC4.hh>
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#include <exception>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 using namespace std::literals;
 using namespace qpdf;
@@ -189,6 +193,16 @@ QPDFWriter::setRecompressFlate(bool val)
     m->recompress_flate = val;
 }
 
+void
+QPDFWriter::setCompressionJobs(int jobs)
+{
+    if (jobs < 0) {
+        throw std::logic_error("QPDFWriter::setCompressionJobs called with a negative value");
+    }
+    m->compression_jobs =
+        jobs == 0 ? std::max(1U, std::thread::hardware_concurrency()) : QIntC::to_size(jobs);
+}
+
 void
 QPDFWriter::setContentNormalization(bool val)
 {
@@ -325,6 +339,18 @@ QPDFWriter::setLinearizationPass1Filename(std::string const& filename)
     m->lin_pass1_filename = filename;
 }
 
+void
+QPDFWriter::setStreamingMode(bool val)
+{
+    m->streaming = val;
+}
+
+void
+QPDFWriter::setIncrementalUpdate(bool val)
+{
+    m->incremental = val;
+}
+
 void
 QPDFWriter::setPCLm(bool val)
 {
@@ -1150,7 +1176,14 @@ QPDFWriter::enqueueObject(QPDFObjectHandle object)
 void
 QPDFWriter::unparseChild(QPDFObjectHandle child, int level, int flags)
 {
-    if (!m->linearized) {
+    if (m->incremental) {
+        // Objects keep their numbers in incremental updates.
+        if (child.isIndirect()) {
+            writeString(child.getObjGen().unparse(' '));
+            writeString(" R");
+            return;
+        }
+    } else if (!m->linearized) {
         enqueueObject(child);
     }
     if (child.isIndirect()) {
@@ -1248,7 +1281,9 @@ QPDFWriter::willFilterStream(
     QPDFObjectHandle stream,
     bool& compress_stream, // out only
     bool& is_metadata,     // out only
-    std::string* stream_data)
+    std::string* stream_data,
+    std::optional<size_t>* raw_length, // out only
+    bool defer_compression)
 {
     compress_stream = false;
     is_metadata = false;
@@ -1292,6 +1327,16 @@ QPDFWriter::willFilterStream(
         QTC::TC("qpdf", "QPDFWriter compressing uncompressed stream");
     }
 
+    if (!filter && raw_length) {
+        // The stream will be written unchanged. If its data is available directly from the input
+        // file, let the caller copy it from there rather than buffering it in stream_data.
+        *raw_length = QPDF::Writer::rawStreamLength(m->pdf, stream);
+        if (*raw_length) {
+            QTC::TC("qpdf", "QPDFWriter copy raw stream data");
+            return false;
+        }
+    }
+
     bool filtered = false;
     for (bool first_attempt: {true, false}) {
         PipelinePopper pp_stream_data(this);
@@ -1305,7 +1350,7 @@ QPDFWriter::willFilterStream(
                 m->pipeline,
                 !filter ? 0
                         : ((normalize ? qpdf_ef_normalize : 0) |
-                           (compress_stream ? qpdf_ef_compress : 0)),
+                           (compress_stream && !defer_compression ? qpdf_ef_compress : 0)),
                 !filter ? qpdf_dl_none : (uncompress ? qpdf_dl_all : m->stream_decode_level),
                 false,
                 first_attempt);
@@ -1337,6 +1382,82 @@ QPDFWriter::willFilterStream(
     return filtered;
 }
 
+void
+QPDFWriter::prepareStreams(QPDFObjectHandle stream)
+{
+    // Call willFilterStream for stream and for the streams that follow it in the queue, in the order
+    // in which they will be written, so that its side effects, including warnings, happen in the
+    // same order as when streams are handled one at a time. Stop once enough data is buffered.
+    // Then compress the data of the streams that need it in parallel.
+    static size_t const max_bytes_per_job = 16 * 1024 * 1024;
+    size_t const max_bytes = m->compression_jobs * max_bytes_per_job;
+    size_t total_bytes = 0;
+    std::vector<std::string*> to_compress;
+
+    auto prepare = [this, &total_bytes, &to_compress](QPDFObjectHandle& s) {
+        auto [it, inserted] = m->prepared_streams.try_emplace(s.getObjGen());
+        if (!inserted) {
+            return;
+        }
+        auto& p = it->second;
+        p.filtered =
+            willFilterStream(s, p.compress, p.is_metadata, &p.data, &p.raw_length, true);
+        if (p.compress) {
+            to_compress.emplace_back(&p.data);
+        }
+        total_bytes += p.data.size();
+    };
+
+    prepare(stream);
+    for (auto i = m->object_queue_front; i < m->object_queue.size() && total_bytes < max_bytes;
+         ++i) {
+        auto& next = m->object_queue.at(i);
+        auto og = next.getObjGen();
+        // Skip object streams, which writeObject writes with writeObjectStream.
+        if (next.isStream() &&
+            !(og.getGen() == 0 && m->object_stream_to_objects.count(og.getObj()))) {
+            prepare(next);
+        }
+    }
+
+    if (to_compress.empty()) {
+        return;
+    }
+    QTC::TC("qpdf", "QPDFWriter compress streams in parallel", to_compress.size() > 1 ? 1 : 0);
+    std::atomic<size_t> next_job{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+        for (size_t i; (i = next_job++) < to_compress.size();) {
+            try {
+                auto& data = *to_compress.at(i);
+                std::string compressed;
+                Pl_String out("compressed stream", nullptr, compressed);
+                Pl_Flate flate("compress stream", &out, Pl_Flate::a_deflate);
+                flate.writeString(data);
+                flate.finish();
+                data = std::move(compressed);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(m->compression_jobs, to_compress.size()); ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t: threads) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
 void
 QPDFWriter::unparseObject(
     QPDFObjectHandle object, int level, int flags, size_t stream_length, bool compress)
@@ -1394,7 +1515,7 @@ QPDFWriter::unparseObject(
         // Before writing, we guarantee that /Extensions, if present, is direct through the ADBE
         // dictionary, so we can modify in place.
 
-        const bool is_root = (old_og == m->root_og);
+        const bool is_root = (old_og == m->root_og) && !m->incremental;
         bool have_extensions_other = false;
         bool have_extensions_adbe = false;
 
@@ -1556,12 +1677,31 @@ QPDFWriter::unparseObject(
         bool compress_stream = false;
         bool is_metadata = false;
         std::string stream_data;
-        if (willFilterStream(object, compress_stream, is_metadata, &stream_data)) {
+        std::optional<size_t> raw_length;
+        bool filtered = false;
+        if (m->compression_jobs > 1) {
+            auto prepared = m->prepared_streams.find(old_og);
+            if (prepared == m->prepared_streams.end()) {
+                prepareStreams(object);
+                prepared = m->prepared_streams.find(old_og);
+            }
+            auto& p = prepared->second;
+            stream_data = std::move(p.data);
+            raw_length = p.raw_length;
+            filtered = p.filtered;
+            compress_stream = p.compress;
+            is_metadata = p.is_metadata;
+            m->prepared_streams.erase(prepared);
+        } else {
+            filtered =
+                willFilterStream(object, compress_stream, is_metadata, &stream_data, &raw_length);
+        }
+        if (filtered) {
             flags |= f_filtered;
         }
         QPDFObjectHandle stream_dict = object.getDict();
 
-        m->cur_stream_length = stream_data.size();
+        m->cur_stream_length = raw_length ? *raw_length : stream_data.size();
         if (is_metadata && m->encrypted && (!m->encrypt_metadata)) {
             // Don't encrypt stream data for the metadata stream
             m->cur_data_key.clear();
@@ -1573,7 +1713,11 @@ QPDFWriter::unparseObject(
         {
             PipelinePopper pp_enc(this);
             pushEncryptionFilter(pp_enc);
-            writeString(stream_data);
+            if (raw_length) {
+                last_char = QPDF::Writer::copyRawStreamData(m->pdf, object, *m->pipeline);
+            } else {
+                writeString(stream_data);
+            }
         }
 
         if (m->newline_before_endstream || (m->qdf_mode && last_char != '\n')) {
@@ -1622,14 +1766,15 @@ QPDFWriter::unparseObject(
 }
 
 void
-QPDFWriter::writeObjectStreamOffsets(std::vector<qpdf_offset_t>& offsets, int first_obj)
+QPDFWriter::writeObjectStreamOffsets(
+    std::vector<qpdf_offset_t>& offsets, std::vector<int> const& ids)
 {
     for (size_t i = 0; i < offsets.size(); ++i) {
         if (i != 0) {
             writeStringQDF("\n");
             writeStringNoQDF(" ");
         }
-        writeString(std::to_string(i + QIntC::to_size(first_obj)));
+        writeString(std::to_string(ids.at(i)));
         writeString(" ");
         writeString(std::to_string(offsets.at(i)));
     }
@@ -1644,17 +1789,22 @@ QPDFWriter::writeObjectStream(QPDFObjectHandle object)
 
     QPDFObjGen old_og = object.getObjGen();
     qpdf_assert_debug(old_og.getGen() == 0);
-    int old_id = old_og.getObj();
-    int new_stream_id = m->obj[old_og].renumber;
+    writeObjectStream(
+        m->obj[old_og].renumber, m->object_stream_to_objects[old_og.getObj()], object);
+}
 
+void
+QPDFWriter::writeObjectStream(
+    int new_stream_id, std::vector<QPDFObjGen> const& objects, QPDFObjectHandle object)
+{
     std::vector<qpdf_offset_t> offsets;
+    std::vector<int> ids;
     qpdf_offset_t first = 0;
 
     // Generate stream itself.  We have to do this in two passes so we can calculate offsets in the
     // first pass.
     std::string stream_buffer_pass1;
     std::string stream_buffer_pass2;
-    int first_obj = -1;
     const bool compressed = m->compress_streams && !m->qdf_mode;
     {
         // Pass 1
@@ -1662,12 +1812,10 @@ QPDFWriter::writeObjectStream(QPDFObjectHandle object)
         activatePipelineStack(pp_ostream_pass1, stream_buffer_pass1);
 
         int count = -1;
-        for (auto const& obj: m->object_stream_to_objects[old_id]) {
+        for (auto const& obj: objects) {
             ++count;
             int new_obj = m->obj[obj].renumber;
-            if (first_obj == -1) {
-                first_obj = new_obj;
-            }
+            ids.push_back(new_obj);
             if (m->qdf_mode) {
                 writeString(
                     "%% Object stream: object " + std::to_string(new_obj) + ", index " +
@@ -1714,7 +1862,7 @@ QPDFWriter::writeObjectStream(QPDFObjectHandle object)
         {
             PipelinePopper pp_discard(this);
             activatePipelineStack(pp_discard, true);
-            writeObjectStreamOffsets(offsets, first_obj);
+            writeObjectStreamOffsets(offsets, ids);
             first += m->pipeline->getCount();
         }
 
@@ -1727,7 +1875,7 @@ QPDFWriter::writeObjectStream(QPDFObjectHandle object)
         } else {
             activatePipelineStack(pp_ostream, stream_buffer_pass2);
         }
-        writeObjectStreamOffsets(offsets, first_obj);
+        writeObjectStreamOffsets(offsets, ids);
         writeString(stream_buffer_pass1);
         stream_buffer_pass1.clear();
         stream_buffer_pass1.shrink_to_fit();
@@ -2112,6 +2260,41 @@ QPDFWriter::doWriteSetup()
     }
     m->did_write_setup = true;
 
+    if (m->incremental) {
+        // An incremental update is appended to the original file, so it has to keep the original
+        // structure and encryption. Only settings that affect how individual objects are written
+        // apply.
+        m->linearized = false;
+        m->qdf_mode = false;
+        m->pclm = false;
+        m->streaming = false;
+        m->direct_stream_lengths = true;
+        m->encrypted = false;
+        copyEncryptionParameters(m->pdf);
+        int R = 0;
+        int P = 0;
+        int V = 0;
+        QPDF::encryption_method_e stream_method = QPDF::e_unknown;
+        QPDF::encryption_method_e string_method = QPDF::e_unknown;
+        QPDF::encryption_method_e file_method = QPDF::e_unknown;
+        if (m->pdf.isEncrypted(R, P, V, stream_method, string_method, file_method) && V >= 4) {
+            // copyEncryptionParameters always uses AES for V >= 4, but new objects must be
+            // encrypted the same way as the ones already in the file.
+            if (stream_method != string_method ||
+                !(stream_method == QPDF::e_rc4 || stream_method == QPDF::e_aes ||
+                  stream_method == QPDF::e_aesv3)) {
+                throw std::runtime_error(
+                    "unable to write an incremental update to " + m->pdf.getFilename() +
+                    " because of its encryption parameters");
+            }
+            m->encrypt_use_aes = stream_method != QPDF::e_rc4;
+        }
+        if (m->normalize_content || m->stream_decode_level) {
+            initializeSpecialStreams();
+        }
+        return;
+    }
+
     // Do preliminary setup
 
     if (m->linearized) {
@@ -2171,22 +2354,45 @@ QPDFWriter::doWriteSetup()
         m->direct_stream_lengths = false;
     }
 
-    switch (m->object_stream_mode) {
-    case qpdf_o_disable:
-        initializeTables();
+    if (m->linearized) {
+        m->streaming = false;
+    }
+    if (m->streaming) {
+        // Object streams are generated as objects are written, so object_stream_to_objects stays
+        // empty. Existing object streams are only examined to see whether there are any.
+        m->streaming_object_streams = m->object_stream_mode == qpdf_o_generate;
+        if (m->object_stream_mode == qpdf_o_preserve) {
+            for (auto const& item: QPDF::Writer::getXRefTable(m->pdf)) {
+                if (item.second.getType() == 2) {
+                    m->streaming_object_streams = true;
+                    break;
+                }
+            }
+        }
+        initializeTables(
+            m->streaming_object_streams ? QPDF::Writer::tableSize(m->pdf) / 50U : 0U);
         m->obj.streams_empty = true;
-        break;
+        if (m->streaming_object_streams) {
+            setMinimumPDFVersion("1.5");
+        }
+    } else {
+        switch (m->object_stream_mode) {
+        case qpdf_o_disable:
+            initializeTables();
+            m->obj.streams_empty = true;
+            break;
 
-    case qpdf_o_preserve:
-        initializeTables();
-        preserveObjectStreams();
-        break;
+        case qpdf_o_preserve:
+            initializeTables();
+            preserveObjectStreams();
+            break;
 
-    case qpdf_o_generate:
-        generateObjectStreams();
-        break;
+        case qpdf_o_generate:
+            generateObjectStreams();
+            break;
 
-        // no default so gcc will warn for missing case tag
+            // no default so gcc will warn for missing case tag
+        }
     }
 
     if (!m->obj.streams_empty) {
@@ -2245,16 +2451,27 @@ QPDFWriter::write()
 {
     doWriteSetup();
 
-    // Set up progress reporting. For linearized files, we write two passes. events_expected is an
-    // approximation, but it's good enough for progress reporting, which is mostly a guess anyway.
-    m->events_expected = QIntC::to_int(m->pdf.getObjectCount() * (m->linearized ? 2 : 1));
+    if (m->incremental) {
+        writeIncremental();
+    } else {
+        if (m->streaming) {
+            // Do this before anything else calls QPDF::fixDanglingReferences, which would read the
+            // whole file into memory.
+            QPDF::Writer::fixDanglingReferencesReleasing(m->pdf);
+        }
 
-    prepareFileForWrite();
+        // Set up progress reporting. For linearized files, we write two passes. events_expected is
+        // an approximation, but it's good enough for progress reporting, which is mostly a guess
+        // anyway.
+        m->events_expected = QIntC::to_int(m->pdf.getObjectCount() * (m->linearized ? 2 : 1));
 
-    if (m->linearized) {
-        writeLinearized();
-    } else {
-        writeStandard();
+        prepareFileForWrite();
+
+        if (m->linearized) {
+            writeLinearized();
+        } else {
+            writeStandard();
+        }
     }
 
     m->pipeline->finish();
@@ -2691,8 +2908,41 @@ QPDFWriter::writeLinearized()
     std::string hint_buffer;
 
     // Write file in two passes.  Part numbers refer to PDF spec 1.4.
+    //
+    // The objects in parts 4 through 9 are the same in both passes. Only their offsets after the
+    // hint stream change. If possible, the first pass is written to a temporary file, and these
+    // objects are copied from it in the second pass rather than being written again, which would
+    // repeat the work of filtering and compressing their stream data.
 
     FILE* lin_pass1_file = nullptr;
+    std::unique_ptr<FILE, decltype(&fclose)> pass1_copy(nullptr, &fclose);
+    if (m->lin_pass1_filename.empty()) {
+        pass1_copy.reset(std::tmpfile());
+    }
+    qpdf_offset_t objects_start = 0;
+    qpdf_offset_t objects_end = 0;
+    qpdf_offset_t hint_offset1 = 0;
+    int objects_events = 0;
+    // Copy part of the objects written in pass 1, reporting progress as if they were written again.
+    auto copy_pass1 = [&](qpdf_offset_t start, qpdf_offset_t end, int events_base) {
+        if (QUtil::seek(pass1_copy.get(), start, SEEK_SET) != 0) {
+            throw std::runtime_error("unable to seek in linearization pass 1 temporary file");
+        }
+        char buf[65536];
+        while (start < end) {
+            size_t len =
+                fread(buf, 1, std::min(sizeof(buf), QIntC::to_size(end - start)), pass1_copy.get());
+            if (len == 0) {
+                throw std::runtime_error("error reading linearization pass 1 temporary file");
+            }
+            writeString(std::string_view(buf, len));
+            start += QIntC::to_offset(len);
+            auto events = objects_events * (start - objects_start) / (objects_end - objects_start);
+            while (m->events_seen < events_base + events) {
+                indicateProgress(false, false);
+            }
+        }
+    };
     auto pp_pass1 = std::make_unique<PipelinePopper>(this);
     auto pp_md5 = std::make_unique<PipelinePopper>(this);
     for (int pass: {1, 2}) {
@@ -2701,6 +2951,9 @@ QPDFWriter::writeLinearized()
                 lin_pass1_file = QUtil::safe_fopen(m->lin_pass1_filename.c_str(), "wb");
                 pushPipeline(new Pl_StdioFile("linearization pass1", lin_pass1_file));
                 activatePipelineStack(*pp_pass1);
+            } else if (pass1_copy) {
+                pushPipeline(new Pl_StdioFile("linearization pass1", pass1_copy.get()));
+                activatePipelineStack(*pp_pass1);
             } else {
                 activatePipelineStack(*pp_pass1, true);
             }
@@ -2819,25 +3072,48 @@ QPDFWriter::writeLinearized()
 
         // Parts 4 through 9
 
-        for (auto const& cur_object: m->object_queue) {
-            if (cur_object.getObjectID() == part6_end_marker) {
-                first_half_max_obj_offset = m->pipeline->getCount();
+        if (pass == 2 && pass1_copy) {
+            QTC::TC("qpdf", "QPDFWriter linearized copy pass 1 objects");
+            int events_base = m->events_seen;
+            copy_pass1(objects_start, hint_offset1, events_base);
+            // Part 5: hint stream
+            writeString(hint_buffer);
+            copy_pass1(hint_offset1, objects_end, events_base);
+            // The copied objects that follow the hint stream have moved by its length. The first
+            // half cross-reference data, which has already been written, allows for this itself.
+            for (int id = 1; id <= first_half_end; ++id) {
+                auto& xref = m->new_obj[id].xref;
+                if (id != hint_id && xref.getType() == 1 && xref.getOffset() >= hint_offset1) {
+                    xref = QPDFXRefEntry(xref.getOffset() + hint_length);
+                }
             }
-            writeObject(cur_object);
-            if (cur_object.getObjectID() == part4_end_marker) {
-                if (m->encrypted) {
-                    writeEncryptionDictionary();
+        } else {
+            objects_start = m->pipeline->getCount();
+            objects_events = m->events_seen;
+            for (m->object_queue_front = 0; m->object_queue_front < m->object_queue.size();) {
+                QPDFObjectHandle cur_object = m->object_queue.at(m->object_queue_front);
+                ++m->object_queue_front;
+                if (cur_object.getObjectID() == part6_end_marker) {
+                    first_half_max_obj_offset = m->pipeline->getCount();
                 }
-                if (pass == 1) {
-                    m->new_obj[hint_id].xref = QPDFXRefEntry(m->pipeline->getCount());
-                } else {
-                    // Part 5: hint stream
-                    writeString(hint_buffer);
+                writeObject(cur_object);
+                if (cur_object.getObjectID() == part4_end_marker) {
+                    if (m->encrypted) {
+                        writeEncryptionDictionary();
+                    }
+                    if (pass == 1) {
+                        m->new_obj[hint_id].xref = QPDFXRefEntry(m->pipeline->getCount());
+                    } else {
+                        // Part 5: hint stream
+                        writeString(hint_buffer);
+                    }
+                }
+                if (cur_object.getObjectID() == part6_end_marker) {
+                    part6_end_offset = m->pipeline->getCount();
                 }
             }
-            if (cur_object.getObjectID() == part6_end_marker) {
-                part6_end_offset = m->pipeline->getCount();
-            }
+            objects_end = m->pipeline->getCount();
+            objects_events = m->events_seen - objects_events;
         }
 
         // Part 10: overflow hint stream -- not used
@@ -2902,7 +3178,7 @@ QPDFWriter::writeLinearized()
             pp_pass1 = nullptr;
 
             // Save hint offset since it will be set to zero by calling openObject.
-            qpdf_offset_t hint_offset1 = m->new_obj[hint_id].xref.getOffset();
+            hint_offset1 = m->new_obj[hint_id].xref.getOffset();
 
             // Write hint stream to a buffer
             {
@@ -3041,11 +3317,15 @@ QPDFWriter::writeStandard()
         enqueueObjectsStandard();
     }
 
-    // Now start walking queue, outputting each object.
-    while (m->object_queue_front < m->object_queue.size()) {
-        QPDFObjectHandle cur_object = m->object_queue.at(m->object_queue_front);
-        ++m->object_queue_front;
-        writeObject(cur_object);
+    if (m->streaming) {
+        writeObjectsStreaming();
+    } else {
+        // Now start walking queue, outputting each object.
+        while (m->object_queue_front < m->object_queue.size()) {
+            QPDFObjectHandle cur_object = m->object_queue.at(m->object_queue_front);
+            ++m->object_queue_front;
+            writeObject(cur_object);
+        }
     }
 
     // Write out the encryption dictionary, if any
@@ -3055,7 +3335,7 @@ QPDFWriter::writeStandard()
 
     // Now write out xref.  next_objid is now the number of objects.
     qpdf_offset_t xref_offset = m->pipeline->getCount();
-    if (m->object_stream_to_objects.empty()) {
+    if (m->object_stream_to_objects.empty() && !m->streaming_object_streams) {
         // Write regular cross-reference table
         writeXRefTable(t_normal, 0, m->next_objid - 1, m->next_objid);
     } else {
@@ -3075,3 +3355,256 @@ QPDFWriter::writeStandard()
             m->object_stream_to_objects.empty() ? 0 : 1);
     }
 }
+
+void
+QPDFWriter::writeObjectsStreaming()
+{
+    // Write the objects in the queue as in writeStandard, but release the value of each object
+    // once it has been written, so that it is read again from the input if it is needed later, for
+    // example by a stream data provider. Objects that were resolved before writing started may
+    // have been modified, and objects that are referenced directly from the trailer are needed
+    // when the trailer is written last, so these are kept. Once warnings have been issued, nothing
+    // more is released, as reading objects again would repeat them. If object streams are wanted,
+    // objects that may go into an object stream are set aside as they are reached and written as a
+    // new object stream whenever 100 of them have been collected. Unlike in generateObjectStreams,
+    // their object numbers have already been assigned when they were first referenced, so they are
+    // not consecutive.
+    static size_t const max_per_object_stream = 100;
+    auto encryption_dict_og = m->pdf.getTrailer().getKey("/Encrypt").getObjGen();
+    auto keep = QPDF::Writer::getResolvedObjects(m->pdf);
+    for (auto const& item: m->pdf.getTrailer().as_dictionary()) {
+        if (item.second.isIndirect()) {
+            keep.insert(item.second.getObjGen());
+        }
+    }
+    auto const n_warnings = m->pdf.numWarnings();
+    auto release = [this, &keep, n_warnings](QPDFObjGen og) {
+        if (!keep.count(og) && m->pdf.numWarnings() == n_warnings) {
+            QPDF::Writer::releaseObject(m->pdf, og);
+        }
+    };
+    auto compressible = [this, &encryption_dict_og](QPDFObjectHandle& object) {
+        // These are the same restrictions as those applied by QPDF::getCompressibleObjGens and
+        // doWriteSetup.
+        auto og = object.getObjGen();
+        return !(
+            object.isStream() || og == encryption_dict_og ||
+            (m->encrypted && og == m->root_og) ||
+            (object.isDictionaryOfType("/Sig") && object.hasKey("/ByteRange") &&
+             object.hasKey("/Contents")));
+    };
+    std::vector<QPDFObjGen> pending;
+    auto write_pending = [this, &pending, &release]() {
+        QTC::TC("qpdf", "QPDFWriter streaming object stream");
+        writeObjectStream(m->next_objid++, pending, QPDFObjectHandle::newNull());
+        for (auto const& og: pending) {
+            release(og);
+        }
+        pending.clear();
+    };
+
+    while (m->object_queue_front < m->object_queue.size() || !pending.empty()) {
+        if (m->object_queue_front == m->object_queue.size()) {
+            // Writing the collected objects may add more objects to the queue.
+            write_pending();
+            continue;
+        }
+        QPDFObjectHandle cur_object = std::move(m->object_queue.at(m->object_queue_front));
+        ++m->object_queue_front;
+        if (m->object_queue_front >= 1024 && 2 * m->object_queue_front >= m->object_queue.size()) {
+            // Drop the part of the queue that has been written.
+            m->object_queue.erase(
+                m->object_queue.begin(),
+                m->object_queue.begin() + static_cast<std::ptrdiff_t>(m->object_queue_front));
+            m->object_queue_front = 0;
+        }
+        if (m->streaming_object_streams && compressible(cur_object)) {
+            pending.emplace_back(cur_object.getObjGen());
+            if (pending.size() == max_per_object_stream) {
+                write_pending();
+            }
+            continue;
+        }
+        writeObject(cur_object);
+        release(cur_object.getObjGen());
+    }
+}
+
+void
+QPDFWriter::writeIncremental()
+{
+    bool prev_is_stream = false;
+    auto prev = QPDF::Writer::getStartXRef(m->pdf, prev_is_stream);
+    if (prev == 0) {
+        throw std::runtime_error(
+            "unable to write an incremental update to " + m->pdf.getFilename() +
+            " because its cross-reference data could not be used");
+    }
+
+    auto trailer = m->pdf.getTrailer();
+    auto encrypt_og = trailer.getKey("/Encrypt").getObjGen();
+    std::vector<std::pair<QPDFObjGen, qpdf_offset_t>> written;
+    auto objects = QPDF::Writer::getModifiedObjects(m->pdf);
+    // The encryption dictionary is never encrypted, so it can't be written like other objects.
+    objects.erase(std::remove(objects.begin(), objects.end(), encrypt_og), objects.end());
+    m->events_expected = std::max(1, QIntC::to_int(objects.size()));
+
+    auto last = QPDF::Writer::copyInputFile(m->pdf, *m->pipeline);
+    if (objects.empty()) {
+        // Nothing has changed, so there is nothing to append.
+        QTC::TC("qpdf", "QPDFWriter incremental update unchanged");
+        return;
+    }
+    if (last != '\n' && last != '\r') {
+        writeString("\n");
+    }
+
+    int size = trailer.getKey("/Size").isInteger() ? trailer.getKey("/Size").getIntValueAsInt() : 0;
+    for (auto const& og: objects) {
+        indicateProgress(false, false);
+        size = std::max(size, og.getObj() + 1);
+        written.emplace_back(og, m->pipeline->getCount());
+        writeString(og.unparse(' '));
+        writeString(" obj\n");
+        if (m->encrypted) {
+            m->cur_data_key = QPDF::compute_data_key(
+                m->encryption_key,
+                og.getObj(),
+                og.getGen(),
+                m->encrypt_use_aes,
+                m->encryption_V,
+                m->encryption_R);
+        }
+        unparseObject(m->pdf.getObject(og), 0, 0);
+        m->cur_data_key.clear();
+        writeString("\nendobj\n");
+    }
+    QTC::TC("qpdf", "QPDFWriter incremental update", prev_is_stream ? 1 : 0);
+
+    // The new trailer replaces the old one, so it repeats everything except the cross-reference
+    // data of the previous section.
+    auto write_trailer_keys = [&]() {
+        auto new_trailer = getTrimmedTrailer();
+        for (auto const& key: {"/ID", "/Encrypt"}) {
+            if (trailer.hasKey(key)) {
+                new_trailer.replaceKey(key, trailer.getKey(key));
+            }
+        }
+        new_trailer.removeKey("/Size");
+        for (auto const& [key, value]: new_trailer.as_dictionary()) {
+            if (!value.null()) {
+                writeString(" ");
+                writeString(Name::normalize(key));
+                writeString(" ");
+                unparseChild(value, 1, 0);
+            }
+        }
+        writeString(" /Prev ");
+        writeString(std::to_string(prev));
+    };
+
+    qpdf_offset_t xref_offset = m->pipeline->getCount();
+    if (prev_is_stream) {
+        // The previous section was a cross-reference stream, so readers of the original file may
+        // not understand cross-reference tables.
+        QPDFObjGen xref_og(size++, 0);
+        written.emplace_back(xref_og, xref_offset);
+    }
+    std::sort(written.begin(), written.end());
+
+    // Entries are grouped into subsections of consecutive object numbers. Only one generation of
+    // an object can be listed.
+    std::vector<std::pair<int, int>> subsections;
+    int last_id = 0;
+    for (auto const& [og, offset]: written) {
+        if (og.getObj() == last_id) {
+            continue;
+        }
+        if (subsections.empty() || og.getObj() != last_id + 1) {
+            subsections.emplace_back(og.getObj(), 0);
+        }
+        ++subsections.back().second;
+        last_id = og.getObj();
+    }
+
+    if (prev_is_stream) {
+        unsigned int f1_size = std::max(bytesNeeded(xref_offset), 1U);
+        unsigned int f2_size = 1;
+        for (auto const& [og, offset]: written) {
+            f2_size = std::max(f2_size, bytesNeeded(og.getGen()));
+        }
+        std::string data;
+        auto put = [&data](unsigned long long val, unsigned int bytes) {
+            for (unsigned int i = bytes; i > 0; --i) {
+                data += static_cast<char>((val >> (8 * (i - 1))) & 0xff);
+            }
+        };
+        last_id = 0;
+        for (auto const& [og, offset]: written) {
+            if (og.getObj() != last_id) {
+                put(1, 1);
+                put(QIntC::to_ulonglong(offset), f1_size);
+                put(QIntC::to_ulonglong(og.getGen()), f2_size);
+                last_id = og.getObj();
+            }
+        }
+        if (m->compress_streams) {
+            std::string compressed;
+            Pl_String out("compressed xref stream", nullptr, compressed);
+            Pl_Flate flate("compress xref stream", &out, Pl_Flate::a_deflate);
+            flate.writeString(data);
+            flate.finish();
+            data = std::move(compressed);
+        }
+
+        writeString(std::to_string(size - 1));
+        writeString(" 0 obj\n<< /Type /XRef /Size ");
+        writeString(std::to_string(size));
+        writeString(" /W [ 1 ");
+        writeString(std::to_string(f1_size));
+        writeString(" ");
+        writeString(std::to_string(f2_size));
+        writeString(" ] /Index [");
+        for (auto const& [first, count]: subsections) {
+            writeString(" ");
+            writeString(std::to_string(first));
+            writeString(" ");
+            writeString(std::to_string(count));
+        }
+        writeString(" ]");
+        write_trailer_keys();
+        if (m->compress_streams) {
+            writeString(" /Filter /FlateDecode");
+        }
+        writeString(" /Length ");
+        writeString(std::to_string(data.size()));
+        writeString(" >>\nstream\n");
+        writeString(data);
+        writeString("\nendstream\nendobj\n");
+    } else {
+        writeString("xref\n");
+        auto entry = written.cbegin();
+        for (auto const& [first, count]: subsections) {
+            writeString(std::to_string(first));
+            writeString(" ");
+            writeString(std::to_string(count));
+            writeString("\n");
+            for (int i = 0; i < count; ++i) {
+                while (entry->first.getObj() != first + i) {
+                    ++entry;
+                }
+                writeString(QUtil::int_to_string(entry->second, 10));
+                writeString(" ");
+                writeString(QUtil::int_to_string(entry->first.getGen(), 5));
+                writeString(" n \n");
+            }
+        }
+        writeString("trailer << /Size ");
+        writeString(std::to_string(size));
+        write_trailer_keys();
+        writeString(" >>\n");
+    }
+    writeString("startxref\n");
+    writeString(std::to_string(xref_offset));
+    writeString("\n%%EOF\n");
+}
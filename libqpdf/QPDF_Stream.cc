@@ -4,7 +4,9 @@
 #include <qpdf/JSON_writer.hh>
 #include <qpdf/Pipeline.hh>
 #include <qpdf/Pl_Base64.hh>
+#include <qpdf/Pl_Bounded.hh>
 #include <qpdf/Pl_Buffer.hh>
+#include <qpdf/Pl_Concatenate.hh>
 #include <qpdf/Pl_Count.hh>
 #include <qpdf/Pl_Discard.hh>
 #include <qpdf/Pl_Flate.hh>
@@ -184,8 +186,12 @@ Stream::writeStreamJSON(
         return decode_level;
     }
 
+    // Whether the data can be decoded is only known once all of it has been decoded, so it has to
+    // be piped once before anything is written. Small streams are kept from that pass. Larger ones
+    // are piped again straight to their destination so that memory use does not depend on their
+    // size.
     Pl_Discard discard;
-    Pl_Buffer buf_pl{"stream data"};
+    Pl_Bounded buf_pl{"stream data", 1024 * 1024};
     Pipeline* data_pipeline = &buf_pl;
     if (no_data_key && json_data == qpdf_sj_inline) {
         data_pipeline = &discard;
@@ -201,7 +207,7 @@ Stream::writeStreamJSON(
             // Try again
             filter = false;
             decode_level = qpdf_dl_none;
-            buf_pl.getString(); // reset buf_pl
+            buf_pl.reset();
         } else {
             buf_pl_ready = true;
             break;
@@ -210,6 +216,18 @@ Stream::writeStreamJSON(
     if (!buf_pl_ready) {
         throw std::logic_error("QPDF_Stream: failed to get stream data");
     }
+    auto write_data = [this, &buf_pl, decode_level](Pipeline& next) {
+        if (buf_pl.fits()) {
+            next.writeString(buf_pl.getString());
+            return;
+        }
+        // Any warnings were issued by the first pass.
+        Pl_Concatenate concat{"stream data", &next};
+        QPDF::Pipe::QuietWarnings quiet{obj->getQPDF()};
+        if (!pipeStreamData(&concat, nullptr, 0, decode_level, true, false)) {
+            throw std::logic_error("QPDF_Stream: failed to get stream data");
+        }
+    };
     // We can use unsafeShallowCopy because we are only touching top-level keys.
     auto dict = s->stream_dict.unsafeShallowCopy();
     dict.removeKey("/Length");
@@ -219,11 +237,11 @@ Stream::writeStreamJSON(
     }
     if (json_data == qpdf_sj_file) {
         jw.writeNext() << R"("datafile": ")" << JSON::Writer::encode_string(data_filename) << "\"";
-        p->writeString(buf_pl.getString());
+        write_data(*p);
     } else if (json_data == qpdf_sj_inline) {
         if (!no_data_key) {
             jw.writeNext() << R"("data": ")";
-            jw.writeBase64(buf_pl.getString()) << "\"";
+            jw.writeBase64(write_data) << "\"";
         }
     } else {
         throw std::logic_error("QPDF_Stream::writeStreamJSON : unexpected value of json_data");
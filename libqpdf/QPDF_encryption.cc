@@ -11,13 +11,17 @@
 #include <qpdf/Pl_AES_PDF.hh>
 #include <qpdf/Pl_Buffer.hh>
 #include <qpdf/Pl_RC4.hh>
-#include <qpdf/Pl_SHA2.hh>
+#include <qpdf/QPDFCryptoBulk.hh>
+#include <qpdf/QPDFCryptoProvider.hh>
 #include <qpdf/QTC.hh>
 #include <qpdf/QUtil.hh>
 #include <qpdf/RC4.hh>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <mutex>
+#include <thread>
 
 static unsigned char const padding_string[] = {
     0x28, 0xbf, 0x4e, 0x5e, 0x4e, 0x75, 0x8a, 0x41, 0x64, 0x00, 0x4e, 0x56, 0xff, 0xfa, 0x01, 0x08,
@@ -236,29 +240,73 @@ process_with_aes(
     }
 }
 
-static std::string
-hash_V5(
-    std::string const& password,
-    std::string const& salt,
-    std::string const& udata,
-    QPDF::EncryptionData const& data)
+namespace
 {
-    Pl_SHA2 hash(256);
-    hash.writeString(password);
-    hash.writeString(salt);
-    hash.writeString(udata);
-    hash.finish();
-    std::string K = hash.getRawDigest();
+    // The inputs and the result of hash_V5
+    struct HashV5
+    {
+        std::string password;
+        std::string salt;
+        std::string udata;
+        std::string result;
+    };
+} // namespace
 
-    std::string result;
-    if (data.getR() < 6) {
-        result = K;
-    } else {
+// Compute hash_V5 for each of hashes. For R6, the rounds of the different hashes are run side by
+// side so that the SHA-2 digests of a round can be computed together if the crypto implementation
+// supports it.
+static void
+hash_V5(std::vector<HashV5>& hashes, QPDF::EncryptionData const& data)
+{
+    // Use a single crypto implementation for all rounds, and encrypt all blocks of a round at once
+    // and hash the data of all hashes at once if it allows.
+    auto crypto = QPDFCryptoProvider::getImpl();
+    auto bulk = dynamic_cast<QPDFCryptoBulk*>(crypto.get());
+    size_t const n = hashes.size();
+    std::vector<std::string> K(n);
+
+    // Set K[i] to the SHA-2 digest of messages[i] for each i in which.
+    auto sha2 = [&](int bits, std::vector<size_t> const& which,
+                    std::vector<std::string> const& messages) {
+        if (which.empty()) {
+            return;
+        }
+        std::vector<unsigned char const*> in_data;
+        std::vector<size_t> lens;
+        std::vector<unsigned char*> out_data;
+        for (auto i: which) {
+            K[i].resize(QIntC::to_size(bits / 8));
+            in_data.push_back(QUtil::unsigned_char_pointer(messages[i]));
+            lens.push_back(messages[i].length());
+            out_data.push_back(QUtil::unsigned_char_pointer(K[i]));
+        }
+        if (bulk) {
+            bulk->SHA2_batch(bits, which.size(), in_data.data(), lens.data(), out_data.data());
+        } else {
+            for (size_t j = 0; j < which.size(); ++j) {
+                crypto->SHA2_init(bits);
+                crypto->SHA2_update(in_data[j], lens[j]);
+                crypto->SHA2_finalize();
+                K[which[j]] = crypto->SHA2_digest();
+            }
+        }
+    };
+
+    std::vector<size_t> active;
+    std::vector<std::string> E(n);
+    for (size_t i = 0; i < n; ++i) {
+        active.push_back(i);
+        E[i] = hashes[i].password + hashes[i].salt + hashes[i].udata;
+    }
+    sha2(256, active, E);
+
+    if (data.getR() >= 6) {
         // Algorithm 2.B from ISO 32000-1 chapter 7: Computing a hash
 
+        // Each round encrypts and hashes 64 copies of password + K + udata.
+        std::string K1;
         int round_number = 0;
-        bool done = false;
-        while (!done) {
+        while (!active.empty()) {
             // The hash algorithm has us setting K initially to the R5 value and then repeating a
             // series of steps 64 times before starting with the termination case testing.  The
             // wording of the specification is very unclear as to the exact number of times it
@@ -272,44 +320,78 @@ hash_V5(
             // terminated repetition.
 
             ++round_number;
-            std::string K1 = password + K + udata;
-            qpdf_assert_debug(K.length() >= 32);
-            std::string E = process_with_aes(
-                K.substr(0, 16),
-                true,
-                K1,
-                0,
-                64,
-                QUtil::unsigned_char_pointer(K.substr(16, 16)),
-                16);
-
-            // E_mod_3 is supposed to be mod 3 of the first 16 bytes of E taken as as a (128-bit)
-            // big-endian number.  Since (xy mod n) is equal to ((x mod n) + (y mod n)) mod n and
-            // since 256 mod n is 1, we can just take the sums of the the mod 3s of each byte to get
-            // the same result.
-            int E_mod_3 = 0;
-            for (unsigned int i = 0; i < 16; ++i) {
-                E_mod_3 += static_cast<unsigned char>(E.at(i));
+            // The hashes whose next digest is SHA-256, SHA-384, and SHA-512
+            std::vector<size_t> next_hash[3];
+            for (auto i: active) {
+                auto const& h = hashes[i];
+                qpdf_assert_debug(K[i].length() >= 32);
+                K1.clear();
+                for (int j = 0; j < 64; ++j) {
+                    K1 += h.password;
+                    K1 += K[i];
+                    K1 += h.udata;
+                }
+                // The length of K1 is a multiple of 64, so no padding is needed.
+                E[i].resize(K1.length());
+                auto key = QUtil::unsigned_char_pointer(K[i]);
+                auto in = QUtil::unsigned_char_pointer(K1);
+                auto out = QUtil::unsigned_char_pointer(E[i]);
+                if (bulk) {
+                    bulk->rijndael_cbc(true, key, 16, key + 16, in, out, K1.length());
+                } else {
+                    unsigned char cbc_block[QPDFCryptoImpl::rijndael_buf_size];
+                    memcpy(cbc_block, key + 16, sizeof(cbc_block));
+                    crypto->rijndael_init(true, key, 16, true, cbc_block);
+                    for (size_t j = 0; j < K1.length(); j += QPDFCryptoImpl::rijndael_buf_size) {
+                        crypto->rijndael_process(in + j, out + j);
+                    }
+                    crypto->rijndael_finalize();
+                }
+
+                // E_mod_3 is supposed to be mod 3 of the first 16 bytes of E taken as as a
+                // (128-bit) big-endian number.  Since (xy mod n) is equal to ((x mod n) + (y mod
+                // n)) mod n and since 256 mod n is 1, we can just take the sums of the the mod 3s
+                // of each byte to get the same result.
+                int E_mod_3 = 0;
+                for (unsigned int j = 0; j < 16; ++j) {
+                    E_mod_3 += static_cast<unsigned char>(E[i].at(j));
+                }
+                E_mod_3 %= 3;
+                next_hash[E_mod_3].push_back(i);
             }
-            E_mod_3 %= 3;
-            int next_hash = ((E_mod_3 == 0) ? 256 : (E_mod_3 == 1) ? 384 : 512);
-            Pl_SHA2 sha2(next_hash);
-            sha2.writeString(E);
-            sha2.finish();
-            K = sha2.getRawDigest();
+            sha2(256, next_hash[0], E);
+            sha2(384, next_hash[1], E);
+            sha2(512, next_hash[2], E);
 
             if (round_number >= 64) {
-                unsigned int ch = static_cast<unsigned char>(*(E.rbegin()));
-
-                if (ch <= QIntC::to_uint(round_number - 32)) {
-                    done = true;
-                }
+                active.erase(
+                    std::remove_if(
+                        active.begin(),
+                        active.end(),
+                        [&](size_t i) {
+                            unsigned int ch = static_cast<unsigned char>(*(E[i].rbegin()));
+                            return ch <= QIntC::to_uint(round_number - 32);
+                        }),
+                    active.end());
             }
         }
-        result = K.substr(0, 32);
     }
 
-    return result;
+    for (size_t i = 0; i < n; ++i) {
+        hashes[i].result = K[i].substr(0, 32);
+    }
+}
+
+static std::string
+hash_V5(
+    std::string const& password,
+    std::string const& salt,
+    std::string const& udata,
+    QPDF::EncryptionData const& data)
+{
+    std::vector<HashV5> hashes{{password, salt, udata, ""}};
+    hash_V5(hashes, data);
+    return hashes.at(0).result;
 }
 
 static void
@@ -589,6 +671,148 @@ check_owner_password(
     }
 }
 
+namespace
+{
+    struct PasswordCheck
+    {
+        bool owner_matched{false};
+        bool user_matched{false};
+        // For V < 5, the user password is recovered if the owner password matches.
+        std::string user_password;
+    };
+} // namespace
+
+static PasswordCheck
+check_password(std::string const& password, QPDF::EncryptionData const& data)
+{
+    PasswordCheck result;
+    result.owner_matched = check_owner_password(result.user_password, password, data);
+    if (result.owner_matched && (data.getV() < 5)) {
+        // password supplied was owner password; user_password has been initialized for V < 5
+        std::string user_password = result.user_password;
+        QPDF::trim_user_password(user_password);
+        result.user_matched = (user_password == password);
+    } else {
+        result.user_matched = check_user_password(password, data);
+        if (result.user_matched) {
+            result.user_password = password;
+        }
+    }
+    return result;
+}
+
+// Check passwords[first] through passwords[last - 1] for V >= 5 as check_password does, computing
+// all their hashes together.
+static void
+check_passwords_V5(
+    std::vector<std::string> const& passwords,
+    size_t first,
+    size_t last,
+    QPDF::EncryptionData const& data,
+    std::vector<PasswordCheck>& checks)
+{
+    // Algorithms 3.11 and 3.12 from the PDF 1.7 extension level 3
+
+    std::string user_data = data.getU().substr(0, 48);
+    std::string user_salt = data.getU().substr(32, 8);
+    std::string owner_data = data.getO().substr(0, 32);
+    std::string owner_salt = data.getO().substr(32, 8);
+    std::vector<HashV5> hashes;
+    for (size_t i = first; i < last; ++i) {
+        std::string password = truncate_password_V5(passwords[i]);
+        hashes.push_back({password, owner_salt, user_data, ""});
+        hashes.push_back({password, user_salt, "", ""});
+    }
+    hash_V5(hashes, data);
+    for (size_t i = first; i < last; ++i) {
+        auto& check = checks[i];
+        check.owner_matched = (hashes[2 * (i - first)].result == owner_data);
+        check.user_matched = (hashes[2 * (i - first) + 1].result == user_data.substr(0, 32));
+        if (check.user_matched) {
+            check.user_password = passwords[i];
+        }
+    }
+}
+
+// Return the index of the first of passwords that matches, or passwords.size() if none does. If
+// one matches, result is set to its PasswordCheck. For V >= 5, passwords are checked in batches
+// whose hashes are computed together, using up to jobs threads.
+static size_t
+check_passwords(
+    std::vector<std::string> const& passwords,
+    QPDF::EncryptionData const& data,
+    size_t jobs,
+    PasswordCheck& result)
+{
+    size_t const n = passwords.size();
+    std::vector<PasswordCheck> checks(n);
+    if (data.getV() < 5) {
+        // For V < 5, checking a password is cheap, so don't bother with batches or threads.
+        for (size_t i = 0; i < n; ++i) {
+            checks[i] = check_password(passwords[i], data);
+            if (checks[i].owner_matched || checks[i].user_matched) {
+                result = checks[i];
+                return i;
+            }
+        }
+        return n;
+    }
+
+    // Give each thread at least one batch. Larger batches make better use of hashing several
+    // messages at once, but more passwords after a match may be checked needlessly.
+    static size_t constexpr max_batch_size = 8;
+    jobs = std::max(jobs, size_t(1));
+    size_t const batch_size = std::min(max_batch_size, std::max((n + jobs - 1) / jobs, size_t(1)));
+    size_t const batches = (n + batch_size - 1) / batch_size;
+
+    // Batches are taken in order, and no batch after the first match found so far is started, so
+    // every password before the first match is checked.
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> found{n};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+        for (size_t first; (first = next.fetch_add(batch_size)) < found;) {
+            size_t last = std::min(first + batch_size, n);
+            try {
+                check_passwords_V5(passwords, first, last, data, checks);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                return;
+            }
+            for (size_t i = first; i < last; ++i) {
+                if (checks[i].owner_matched || checks[i].user_matched) {
+                    size_t f = found;
+                    while (i < f && !found.compare_exchange_weak(f, i)) {
+                    }
+                    return;
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    if (jobs > 1 && batches > 1) {
+        QTC::TC("qpdf", "QPDF_encryption password candidates in parallel");
+        for (size_t i = 1; i < std::min(jobs, batches); ++i) {
+            threads.emplace_back(worker);
+        }
+    }
+    worker();
+    for (auto& t: threads) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (found < n) {
+        result = checks[found];
+    }
+    return found;
+}
+
 std::string
 QPDF::recover_encryption_key_with_password(std::string const& password, EncryptionData const& data)
 {
@@ -908,20 +1132,23 @@ QPDF::initializeEncryption()
     if (m->provided_password_is_hex_key) {
         // ignore passwords in file
     } else {
-        m->encp->owner_password_matched =
-            check_owner_password(m->encp->user_password, m->encp->provided_password, data);
-        if (m->encp->owner_password_matched && (V < 5)) {
-            // password supplied was owner password; user_password has been initialized for V < 5
-            if (getTrimmedUserPassword() == m->encp->provided_password) {
-                m->encp->user_password_matched = true;
-                QTC::TC("qpdf", "QPDF_encryption user matches owner V < 5");
-            }
-        } else {
-            m->encp->user_password_matched = check_user_password(m->encp->provided_password, data);
-            if (m->encp->user_password_matched) {
-                m->encp->user_password = m->encp->provided_password;
+        auto check = check_password(m->encp->provided_password, data);
+        if (!(check.owner_matched || check.user_matched) && !m->password_candidates.empty()) {
+            size_t i = check_passwords(
+                m->password_candidates, data, m->password_candidate_jobs, check);
+            if (i < m->password_candidates.size()) {
+                QTC::TC("qpdf", "QPDF_encryption password candidate matched", (V < 5) ? 0 : 1);
+                m->encp->provided_password = m->password_candidates.at(i);
             }
         }
+        m->encp->owner_password_matched = check.owner_matched;
+        m->encp->user_password_matched = check.user_matched;
+        if (check.owner_matched || check.user_matched) {
+            m->encp->user_password = check.user_password;
+        }
+        if (check.owner_matched && check.user_matched && (V < 5)) {
+            QTC::TC("qpdf", "QPDF_encryption user matches owner V < 5");
+        }
         if (m->encp->user_password_matched && m->encp->owner_password_matched) {
             QTC::TC("qpdf", "QPDF_encryption same password", (V < 5) ? 0 : 1);
         }
@@ -958,18 +1185,32 @@ QPDF::getKeyForObject(std::shared_ptr<EncryptionParameters> encp, QPDFObjGen og,
         throw std::logic_error("request for encryption key in non-encrypted PDF");
     }
 
-    if (og != encp->cached_key_og) {
-        encp->cached_object_encryption_key = compute_data_key(
-            encp->encryption_key,
-            og.getObj(),
-            og.getGen(),
-            use_aes,
-            encp->encryption_V,
-            encp->encryption_R);
-        encp->cached_key_og = og;
+    if (encp->encryption_V >= 5) {
+        // The file's key is used for all objects.
+        return encp->encryption_key;
     }
 
-    return encp->cached_object_encryption_key;
+    if (encp->object_keys.empty()) {
+        encp->object_keys.resize(EncryptionParameters::object_key_slots);
+    }
+    auto& slot = encp->object_keys.at(
+        (2 * static_cast<size_t>(og.getObj()) + (use_aes ? 1 : 0)) %
+        EncryptionParameters::object_key_slots);
+    if (slot.og == og && slot.use_aes == use_aes && !slot.key.empty()) {
+        ++encp->object_key_hits;
+        return slot.key;
+    }
+    ++encp->object_key_misses;
+    slot.og = og;
+    slot.use_aes = use_aes;
+    slot.key = compute_data_key(
+        encp->encryption_key,
+        og.getObj(),
+        og.getGen(),
+        use_aes,
+        encp->encryption_V,
+        encp->encryption_R);
+    return slot.key;
 }
 
 void
@@ -1209,6 +1450,12 @@ QPDF::getPaddedUserPassword() const
     return m->encp->user_password;
 }
 
+std::string const&
+QPDF::getMatchedPassword() const
+{
+    return m->encp->provided_password;
+}
+
 std::string
 QPDF::getTrimmedUserPassword() const
 {
@@ -1,6 +1,7 @@
 #include <qpdf/QPDF.hh>
 
 #include <qpdf/FileInputSource.hh>
+#include <qpdf/JSON_parser.hh>
 #include <qpdf/JSON_writer.hh>
 #include <qpdf/Pl_Base64.hh>
 #include <qpdf/Pl_StdioFile.hh>
@@ -66,39 +67,42 @@ static char const* JSON_PDF = (
 
 // Validator methods -- these are much more performant than std::regex.
 static bool
-is_indirect_object(std::string const& v, int& obj, int& gen)
+is_indirect_object(std::string_view v, int& obj, int& gen)
 {
-    char const* p = v.c_str();
-    std::string o_str;
-    std::string g_str;
-    if (!util::is_digit(*p)) {
+    size_t i = 0;
+    auto at = [&v](size_t pos) { return pos < v.size() ? v[pos] : '\0'; };
+    auto start = i;
+    if (!util::is_digit(at(i))) {
         return false;
     }
-    while (util::is_digit(*p)) {
-        o_str.append(1, *p++);
+    while (util::is_digit(at(i))) {
+        ++i;
     }
-    if (*p != ' ') {
+    std::string o_str(v.substr(start, i - start));
+    if (at(i) != ' ') {
         return false;
     }
-    while (*p == ' ') {
-        ++p;
+    while (at(i) == ' ') {
+        ++i;
     }
-    if (!util::is_digit(*p)) {
+    start = i;
+    if (!util::is_digit(at(i))) {
         return false;
     }
-    while (util::is_digit(*p)) {
-        g_str.append(1, *p++);
+    while (util::is_digit(at(i))) {
+        ++i;
     }
-    if (*p != ' ') {
+    std::string g_str(v.substr(start, i - start));
+    if (at(i) != ' ') {
         return false;
     }
-    while (*p == ' ') {
-        ++p;
+    while (at(i) == ' ') {
+        ++i;
     }
-    if (*p++ != 'R') {
+    if (at(i++) != 'R') {
         return false;
     }
-    if (*p) {
+    if (i != v.size()) {
         return false;
     }
     obj = QUtil::string_to_int(o_str.c_str());
@@ -107,7 +111,7 @@ is_indirect_object(std::string const& v, int& obj, int& gen)
 }
 
 static bool
-is_obj_key(std::string const& v, int& obj, int& gen)
+is_obj_key(std::string_view v, int& obj, int& gen)
 {
     if (v.substr(0, 4) != "obj:") {
         return false;
@@ -116,7 +120,7 @@ is_obj_key(std::string const& v, int& obj, int& gen)
 }
 
 static bool
-is_unicode_string(std::string const& v, std::string& str)
+is_unicode_string(std::string_view v, std::string& str)
 {
     if (v.substr(0, 2) == "u:") {
         str = v.substr(2);
@@ -126,7 +130,7 @@ is_unicode_string(std::string const& v, std::string& str)
 }
 
 static bool
-is_binary_string(std::string const& v, std::string& str)
+is_binary_string(std::string_view v, std::string& str)
 {
     if (v.substr(0, 2) == "b:") {
         str = v.substr(2);
@@ -143,13 +147,13 @@ is_binary_string(std::string const& v, std::string& str)
 }
 
 static bool
-is_name(std::string const& v)
+is_name(std::string_view v)
 {
     return ((v.length() > 1) && (v.at(0) == '/'));
 }
 
 static bool
-is_pdf_name(std::string const& v)
+is_pdf_name(std::string_view v)
 {
     return ((v.length() > 3) && (v.substr(0, 3) == "n:/"));
 }
@@ -232,7 +236,7 @@ provide_data(std::shared_ptr<InputSource> is, qpdf_offset_t start, qpdf_offset_t
     };
 }
 
-class QPDF::JSONReactor: public JSON::Reactor
+class QPDF::JSONReactor: public json::Handler
 {
   public:
     JSONReactor(QPDF& pdf, std::shared_ptr<InputSource> is, bool must_be_complete) :
@@ -247,10 +251,11 @@ class QPDF::JSONReactor: public JSON::Reactor
     ~JSONReactor() override = default;
     void dictionaryStart() override;
     void arrayStart() override;
-    void containerEnd(JSON const& value) override;
+    void containerEnd(json::Value const& value) override;
     void topLevelScalar() override;
-    bool dictionaryItem(std::string const& key, JSON const& value) override;
-    bool arrayItem(JSON const& value) override;
+    void dictionaryItem(std::string_view key, json::Value const& value) override;
+    void arrayItem(json::Value const& value) override;
+    bool skipStringValue(std::string_view key) override;
 
     bool anyErrors() const;
 
@@ -279,11 +284,11 @@ class QPDF::JSONReactor: public JSON::Reactor
     };
 
     void containerStart();
-    bool setNextStateIfDictionary(std::string const& key, JSON const& value, state_e);
-    void setObjectDescription(QPDFObjectHandle& oh, JSON const& value);
-    QPDFObjectHandle makeObject(JSON const& value);
+    bool setNextStateIfDictionary(std::string_view key, json::Value const& value, state_e);
+    void setObjectDescription(QPDFObjectHandle& oh, json::Value const& value);
+    QPDFObjectHandle makeObject(json::Value const& value);
     void error(qpdf_offset_t offset, std::string const& message);
-    void replaceObject(QPDFObjectHandle&& replacement, JSON const& value);
+    void replaceObject(QPDFObjectHandle&& replacement, json::Value const& value);
 
     QPDF& pdf;
     std::shared_ptr<InputSource> is;
@@ -342,6 +347,14 @@ QPDF::JSONReactor::dictionaryStart()
     containerStart();
 }
 
+bool
+QPDF::JSONReactor::skipStringValue(std::string_view key)
+{
+    // Inline stream data is decoded from the input by provide_data when it is needed, so there is
+    // no need for the parser to collect what may be a very large string.
+    return !stack.empty() && stack.back().state == st_stream && key == "data";
+}
+
 void
 QPDF::JSONReactor::arrayStart()
 {
@@ -353,7 +366,7 @@ QPDF::JSONReactor::arrayStart()
 }
 
 void
-QPDF::JSONReactor::containerEnd(JSON const& value)
+QPDF::JSONReactor::containerEnd(json::Value const& value)
 {
     auto from_state = stack.back().state;
     stack.pop_back();
@@ -426,7 +439,7 @@ QPDF::JSONReactor::containerEnd(JSON const& value)
 }
 
 void
-QPDF::JSONReactor::replaceObject(QPDFObjectHandle&& replacement, JSON const& value)
+QPDF::JSONReactor::replaceObject(QPDFObjectHandle&& replacement, json::Value const& value)
 {
     auto& tos = stack.back();
     auto og = tos.object.getObjGen();
@@ -449,19 +462,20 @@ QPDF::JSONReactor::topLevelScalar()
 }
 
 bool
-QPDF::JSONReactor::setNextStateIfDictionary(std::string const& key, JSON const& value, state_e next)
+QPDF::JSONReactor::setNextStateIfDictionary(
+    std::string_view key, json::Value const& value, state_e next)
 {
     // Use this method when the next state is for processing a nested dictionary.
     if (value.isDictionary()) {
         this->next_state = next;
         return true;
     }
-    error(value.getStart(), "\"" + key + "\" must be a dictionary");
+    error(value.getStart(), "\"" + std::string(key) + "\" must be a dictionary");
     return false;
 }
 
-bool
-QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
+void
+QPDF::JSONReactor::dictionaryItem(std::string_view key, json::Value const& value)
 {
     if (stack.empty()) {
         throw std::logic_error("stack is empty in dictionaryItem");
@@ -487,10 +501,11 @@ QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
     } else if (state == st_qpdf_meta) {
         if (key == "pdfversion") {
             this->saw_pdf_version = true;
-            std::string v;
+            std::string_view sv;
             bool okay = false;
-            if (value.getString(v)) {
+            if (value.getString(sv)) {
                 std::string version;
+                std::string v(sv);
                 char const* p = v.c_str();
                 if (QPDF::validatePDFVersion(p, version) && (*p == '\0')) {
                     this->pdf.m->pdf_version = version;
@@ -503,11 +518,10 @@ QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
             }
         } else if (key == "jsonversion") {
             this->saw_json_version = true;
-            std::string v;
+            std::string_view v;
             bool okay = false;
             if (value.getNumber(v)) {
-                std::string version;
-                if (QUtil::string_to_int(v.c_str()) == 2) {
+                if (QUtil::string_to_int(std::string(v).c_str()) == 2) {
                     okay = true;
                 }
             }
@@ -626,7 +640,7 @@ QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
             }
         } else if (key == "data") {
             this->saw_data = true;
-            std::string v;
+            std::string_view v;
             if (!value.getString(v)) {
                 QTC::TC("qpdf", "QPDF_json stream data not string");
                 error(value.getStart(), "\"stream.data\" must be a string");
@@ -643,7 +657,7 @@ QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
             }
         } else if (key == "datafile") {
             this->saw_datafile = true;
-            std::string filename;
+            std::string_view filename;
             if (!value.getString(filename)) {
                 QTC::TC("qpdf", "QPDF_json stream datafile not string");
                 error(
@@ -652,7 +666,7 @@ QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
                 tos.object.replaceStreamData("", uninitialized, uninitialized);
             } else {
                 tos.object.replaceStreamData(
-                    QUtil::file_provider(filename), uninitialized, uninitialized);
+                    QUtil::file_provider(std::string(filename)), uninitialized, uninitialized);
             }
         } else {
             // Ignore unknown keys for forward compatibility.
@@ -672,16 +686,16 @@ QPDF::JSONReactor::dictionaryItem(std::string const& key, JSON const& value)
                 "current object is not stream or dictionary in st_object dictionary item");
         }
         dict.replaceKey(
-            is_pdf_name(key) ? QPDFObjectHandle::parse(key.substr(2)).getName() : key,
+            is_pdf_name(key) ? QPDFObjectHandle::parse(std::string(key.substr(2))).getName()
+                             : std::string(key),
             makeObject(value));
     } else {
         throw std::logic_error("QPDF_json: unknown state " + std::to_string(state));
     }
-    return true;
 }
 
-bool
-QPDF::JSONReactor::arrayItem(JSON const& value)
+void
+QPDF::JSONReactor::arrayItem(json::Value const& value)
 {
     if (stack.empty()) {
         throw std::logic_error("stack is empty in arrayItem");
@@ -702,11 +716,10 @@ QPDF::JSONReactor::arrayItem(JSON const& value)
     } else if (state == st_object) {
         stack.back().object.appendItem(makeObject(value));
     }
-    return true;
 }
 
 void
-QPDF::JSONReactor::setObjectDescription(QPDFObjectHandle& oh, JSON const& value)
+QPDF::JSONReactor::setObjectDescription(QPDFObjectHandle& oh, json::Value const& value)
 {
     auto j_descr = std::get<QPDFObject::JSON_Descr>(*descr);
     if (j_descr.object != cur_object) {
@@ -718,10 +731,10 @@ QPDF::JSONReactor::setObjectDescription(QPDFObjectHandle& oh, JSON const& value)
 }
 
 QPDFObjectHandle
-QPDF::JSONReactor::makeObject(JSON const& value)
+QPDF::JSONReactor::makeObject(json::Value const& value)
 {
     QPDFObjectHandle result;
-    std::string str_v;
+    std::string_view sv;
     bool bool_v = false;
     if (value.isDictionary()) {
         result = QPDFObjectHandle::newDictionary();
@@ -735,7 +748,8 @@ QPDF::JSONReactor::makeObject(JSON const& value)
         result = QPDFObjectHandle::newNull();
     } else if (value.getBool(bool_v)) {
         result = QPDFObjectHandle::newBool(bool_v);
-    } else if (value.getNumber(str_v)) {
+    } else if (value.getNumber(sv)) {
+        std::string str_v(sv);
         if (QUtil::is_long_long(str_v.c_str())) {
             result = QPDFObjectHandle::newInteger(QUtil::string_to_ll(str_v.c_str()));
         } else {
@@ -750,7 +764,8 @@ QPDF::JSONReactor::makeObject(JSON const& value)
             }
             result = QPDFObjectHandle::newReal(str_v);
         }
-    } else if (value.getString(str_v)) {
+    } else if (value.getString(sv)) {
+        std::string_view str_v = sv;
         int obj = 0;
         int gen = 0;
         std::string str;
@@ -761,9 +776,9 @@ QPDF::JSONReactor::makeObject(JSON const& value)
         } else if (is_binary_string(str_v, str)) {
             result = QPDFObjectHandle::newString(QUtil::hex_decode(str));
         } else if (is_name(str_v)) {
-            result = QPDFObjectHandle::newName(str_v);
+            result = QPDFObjectHandle::newName(std::string(str_v));
         } else if (is_pdf_name(str_v)) {
-            result = QPDFObjectHandle::parse(str_v.substr(2));
+            result = QPDFObjectHandle::parse(std::string(str_v.substr(2)));
         } else {
             QTC::TC("qpdf", "QPDF_json unrecognized string value");
             error(value.getStart(), "unrecognized string value");
@@ -810,7 +825,7 @@ QPDF::importJSON(std::shared_ptr<InputSource> is, bool must_be_complete)
 {
     JSONReactor reactor(*this, is, must_be_complete);
     try {
-        JSON::parse(*is, &reactor);
+        json::parse(*is, reactor);
     } catch (std::runtime_error& e) {
         throw std::runtime_error(is->getName() + ": " + e.what());
     }
@@ -9,6 +9,7 @@
 #include <map>
 #include <regex>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include <qpdf/BufferInputSource.hh>
@@ -16,6 +17,8 @@
 #include <qpdf/InputSource_private.hh>
 #include <qpdf/OffsetInputSource.hh>
 #include <qpdf/Pipeline.hh>
+#include <qpdf/Pl_Flate.hh>
+#include <qpdf/Pl_String.hh>
 #include <qpdf/QPDFExc.hh>
 #include <qpdf/QPDFLogger.hh>
 #include <qpdf/QPDFObjectHandle_private.hh>
@@ -274,6 +277,15 @@ QPDF::reconstruct_xref(QPDFExc& e, bool found_startxref)
         }
     }
 
+    // Found objects are inserted starting from the end of the file, which usually means from the
+    // highest id, so make room for all of them up front if most ids below the largest are used.
+    int max_found = 0;
+    for (auto const& found: found_objects) {
+        max_found = std::max(max_found, std::get<0>(found));
+    }
+    if (toS(max_found) < 2 * found_objects.size()) {
+        m->xref_table.reserve_ids(toS(max_found) + 1);
+    }
     auto rend = found_objects.rend();
     for (auto it = found_objects.rbegin(); it != rend; it++) {
         auto [obj, gen, token_start] = *it;
@@ -389,6 +401,7 @@ QPDF::read_xref(qpdf_offset_t xref_offset)
 {
     std::map<int, int> free_table;
     std::set<qpdf_offset_t> visited;
+    bool first = true;
     while (xref_offset) {
         visited.insert(xref_offset);
         char buf[7];
@@ -435,10 +448,19 @@ QPDF::read_xref(qpdf_offset_t xref_offset)
             while (util::is_space(buf[skip])) {
                 ++skip;
             }
+            if (first) {
+                m->startxref = xref_offset;
+                m->startxref_is_stream = false;
+            }
             xref_offset = read_xrefTable(xref_offset + skip);
         } else {
+            if (first) {
+                m->startxref = xref_offset;
+                m->startxref_is_stream = true;
+            }
             xref_offset = read_xrefStream(xref_offset);
         }
+        first = false;
         if (visited.count(xref_offset) != 0) {
             QTC::TC("qpdf", "QPDF xref loop");
             throw damagedPDF("", 0, "loop detected following xref tables");
@@ -451,7 +473,7 @@ QPDF::read_xref(qpdf_offset_t xref_offset)
     int size = m->trailer.getKey("/Size").getIntValueAsInt();
     int max_obj = 0;
     if (!m->xref_table.empty()) {
-        max_obj = m->xref_table.rbegin()->first.getObj();
+        max_obj = m->xref_table.last().getObj();
     }
     if (!m->deleted_objects.empty()) {
         max_obj = std::max(max_obj, *(m->deleted_objects.rbegin()));
@@ -1020,7 +1042,7 @@ QPDF::insertXrefEntry(int obj, int f0, qpdf_offset_t f1, int f2)
         return;
     }
 
-    auto [iter, created] = m->xref_table.try_emplace(QPDFObjGen(obj, (f0 == 2 ? 0 : f2)));
+    auto [entry, created] = m->xref_table.try_emplace(QPDFObjGen(obj, (f0 == 2 ? 0 : f2)));
     if (!created) {
         QTC::TC("qpdf", "QPDF xref reused object");
         return;
@@ -1030,11 +1052,11 @@ QPDF::insertXrefEntry(int obj, int f0, qpdf_offset_t f1, int f2)
     case 1:
         // f2 is generation
         QTC::TC("qpdf", "QPDF xref gen > 0", ((f2 > 0) ? 1 : 0));
-        iter->second = QPDFXRefEntry(f1);
+        entry = QPDFXRefEntry(f1);
         break;
 
     case 2:
-        iter->second = QPDFXRefEntry(toI(f1), f2);
+        entry = QPDFXRefEntry(toI(f1), f2);
         break;
 
     default:
@@ -1080,20 +1102,133 @@ QPDF::showXRefTable()
 // Resolve all objects in the xref table. If this triggers a xref table reconstruction abort and
 // return false. Otherwise return true.
 bool
-QPDF::resolveXRefTable()
+QPDF::resolveXRefTable(bool release)
 {
+    // If release is true, objects that were unresolved on entry are returned to their unresolved
+    // state once they have been resolved, so that they are read again when needed rather than all
+    // being held in memory at once. Objects that were resolved before are left alone, as they may
+    // have been modified or replaced. Once any warnings have been issued, nothing more is released,
+    // as reading objects again would repeat them.
     bool may_change = !m->reconstructed_xref;
-    for (auto& iter: m->xref_table) {
-        if (isUnresolved(iter.first)) {
-            resolve(iter.first);
+    auto const n_warnings = m->warnings.size();
+    std::vector<bool> unresolved_on_entry;
+    if (release) {
+        unresolved_on_entry.reserve(m->xref_table.size());
+        for (auto const& iter: m->xref_table) {
+            unresolved_on_entry.push_back(isUnresolved(iter.first));
+        }
+    }
+    size_t i = 0;
+    for (auto const& [og, entry]: m->xref_table) {
+        if (isUnresolved(og)) {
+            resolve(og);
             if (may_change && m->reconstructed_xref) {
                 return false;
             }
         }
+        if (release && unresolved_on_entry[i] && m->warnings.size() == n_warnings) {
+            QTC::TC("qpdf", "QPDF release object after checking", entry.getType() == 2 ? 1 : 0);
+            m->obj_cache[og].object->unresolve();
+            if (entry.getType() == 2) {
+                m->resolved_object_streams.erase(entry.getObjStreamNumber());
+            }
+        }
+        ++i;
     }
     return true;
 }
 
+std::vector<QPDFObjGen>
+QPDF::getModifiedObjects()
+{
+    // An object that has never been resolved is unchanged. Any other object that is in the xref
+    // table is compared with a copy read again from the input file, which is not cached. Streams
+    // are unchanged if their dictionaries are and their data is still that at the same place in
+    // the input file.
+    auto same = [](QPDFObjectHandle a, QPDFObjectHandle b) {
+        auto as = a.as_stream();
+        auto bs = b.as_stream();
+        if (as || bs) {
+            return as && bs && !as.getStreamDataBuffer() && !as.getStreamDataProvider() &&
+                !as.isDataModified() && a.getParsedOffset() == b.getParsedOffset() &&
+                as.getLength() == bs.getLength() &&
+                as.getDict().unparseResolved() == bs.getDict().unparseResolved();
+        }
+        return a.getTypeCode() == b.getTypeCode() && a.unparseResolved() == b.unparseResolved();
+    };
+
+    // Read the objects in an object stream without caching them. Warnings have already been issued
+    // when the stream was first read.
+    auto read_object_stream = [this](int stream_id) {
+        std::map<int, QPDFObjectHandle> objects;
+        auto obj_stream = getObject(stream_id, 0).as_stream();
+        unsigned int n{0};
+        int first{0};
+        if (!obj_stream ||
+            !(obj_stream.getDict().getKey("/N").getValueAsUInt(n) &&
+              obj_stream.getDict().getKey("/First").getValueAsInt(first))) {
+            return objects;
+        }
+        DecodedObjectStream decoded;
+        decoded.data = obj_stream.getStreamData(qpdf_dl_specialized);
+        readObjectStreamHeader(m->tokenizer, stream_id, n, first, decoded, [](QPDFExc&&) {});
+        auto b_start = decoded.data->getBuffer();
+        for (auto const& [obj_id, obj_offset, obj_size]: decoded.offsets) {
+            Buffer obj_buffer{b_start + obj_offset, obj_size};
+            is::OffsetBuffer in("", &obj_buffer, obj_offset);
+            objects.emplace(obj_id, readObjectInStream(in, stream_id, obj_id));
+        }
+        return objects;
+    };
+
+    std::vector<QPDFObjGen> candidates;
+    for (auto const& [og, entry]: m->obj_cache) {
+        if (!entry.object->isUnresolved() &&
+            entry.object->getTypeCode() != ::ot_destroyed) {
+            candidates.emplace_back(og);
+        }
+    }
+
+    std::map<int, std::map<int, QPDFObjectHandle>> object_streams;
+    std::vector<QPDFObjGen> result;
+    for (auto og: candidates) {
+        auto object = newIndirect(og, m->obj_cache[og].object);
+        auto entry = m->xref_table.get(og);
+        if (!entry) {
+            // Objects that are not in the input and are null, such as the targets of dangling
+            // references, need not be written.
+            if (!object.null()) {
+                QTC::TC("qpdf", "QPDF modified new object");
+                result.emplace_back(og);
+            }
+            continue;
+        }
+        QPDFObjectHandle original;
+        try {
+            if (entry->getType() == 1) {
+                QPDFObjGen a_og;
+                original = readObjectAtOffset(false, entry->getOffset(), "", og, a_og, false);
+            } else if (entry->getType() == 2) {
+                auto stream_id = entry->getObjStreamNumber();
+                auto it = object_streams.find(stream_id);
+                if (it == object_streams.end()) {
+                    it = object_streams.emplace(stream_id, read_object_stream(stream_id)).first;
+                }
+                if (auto found = it->second.find(og.getObj()); found != it->second.end()) {
+                    original = found->second;
+                }
+            }
+        } catch (std::exception&) {
+            // Write the object if it can't be read again.
+        }
+        if (!original || !same(object, original)) {
+            QTC::TC("qpdf", "QPDF modified changed object", entry->getType() == 2 ? 1 : 0);
+            result.emplace_back(og);
+        }
+    }
+    return result;
+}
+
 // Ensure all objects in the pdf file, including those in indirect references, appear in the object
 // cache.
 void
@@ -1116,11 +1251,7 @@ QPDF::getObjectCount()
     // this purpose. After fixDanglingReferences is called, all objects in the xref table will also
     // be in obj_cache.
     fixDanglingReferences();
-    QPDFObjGen og;
-    if (!m->obj_cache.empty()) {
-        og = (*(m->obj_cache.rbegin())).first;
-    }
-    return toS(og.getObj());
+    return toS(m->obj_cache.last().getObj());
 }
 
 std::vector<QPDFObjectHandle>
@@ -1601,16 +1732,6 @@ QPDF::resolve(QPDFObjGen og)
 void
 QPDF::resolveObjectsInStream(int obj_stream_number)
 {
-    auto damaged =
-        [this, obj_stream_number](int id, qpdf_offset_t offset, std::string const& msg) -> QPDFExc {
-        return {
-            qpdf_e_damaged_pdf,
-            m->file->getName() + " object stream " + std::to_string(obj_stream_number),
-            +"object " + std::to_string(id) + " 0",
-            offset,
-            msg};
-    };
-
     if (m->resolved_object_streams.count(obj_stream_number)) {
         return;
     }
@@ -1645,16 +1766,80 @@ QPDF::resolveObjectsInStream(int obj_stream_number)
             "object stream " + std::to_string(obj_stream_number) + " has incorrect keys");
     }
 
-    // id, offset, size
-    std::vector<std::tuple<int, qpdf_offset_t, size_t>> offsets;
+    DecodedObjectStream decoded;
+    if (m->object_stream_jobs > 1) {
+        auto it = m->decoded_object_streams.find(obj_stream_number);
+        if (it == m->decoded_object_streams.end()) {
+            decodeObjectStreams(obj_stream_number);
+            it = m->decoded_object_streams.find(obj_stream_number);
+        }
+        if (it != m->decoded_object_streams.end()) {
+            decoded = std::move(it->second);
+            m->decoded_object_streams_bytes -= decoded.data->getSize();
+            m->decoded_object_streams.erase(it);
+        }
+    }
+    if (!decoded.data) {
+        decoded.data = obj_stream.getStreamData(qpdf_dl_specialized);
+    }
+    if (!decoded.header_read) {
+        readObjectStreamHeader(
+            m->tokenizer, obj_stream_number, n, first, decoded, [this](QPDFExc&& e) {
+                warn(e);
+            });
+    }
+    auto b_start = decoded.data->getBuffer();
 
-    auto bp = obj_stream.getStreamData(qpdf_dl_specialized);
+    // To avoid having to read the object stream multiple times, store all objects that would be
+    // found here in the cache.  Remember that some objects stored here might have been overridden
+    // by new objects appended to the file, so it is necessary to recheck the xref table and only
+    // cache what would actually be resolved here.
+    for (auto const& [obj_id, obj_offset, obj_size]: decoded.offsets) {
+        QPDFObjGen og(obj_id, 0);
+        auto entry = m->xref_table.get(og);
+        // If the object stream is read again after its objects have been released by
+        // resolveXRefTable, objects that are already resolved may have been modified and are kept.
+        if (entry && entry->getType() == 2 && entry->getObjStreamNumber() == obj_stream_number &&
+            isUnresolved(og)) {
+            Buffer obj_buffer{b_start + obj_offset, obj_size};
+            is::OffsetBuffer in("", &obj_buffer, obj_offset);
+            auto oh = readObjectInStream(in, obj_stream_number, obj_id);
+            updateCache(og, oh.getObj(), end_before_space, end_after_space);
+        } else {
+            QTC::TC("qpdf", "QPDF not caching overridden objstm object");
+        }
+    }
+}
 
-    BufferInputSource input("", bp.get());
+void
+QPDF::readObjectStreamHeader(
+    qpdf::Tokenizer& tokenizer,
+    int obj_stream_number,
+    unsigned int n,
+    int first,
+    DecodedObjectStream& decoded,
+    std::function<void(QPDFExc&&)> const& warn_fn)
+{
+    // This is also called by decodeObjectStreams on worker threads. It must not access anything
+    // that may be modified while they run. warn_fn is called for anything that should be reported
+    // as a warning. It may throw an exception to abandon reading the header.
+    auto damaged =
+        [this, obj_stream_number](int id, qpdf_offset_t offset, std::string const& msg) -> QPDFExc {
+        return {
+            qpdf_e_damaged_pdf,
+            m->file->getName() + " object stream " + std::to_string(obj_stream_number),
+            +"object " + std::to_string(id) + " 0",
+            offset,
+            msg};
+    };
 
-    const auto b_size = bp->getSize();
+    auto& offsets = decoded.offsets;
+    offsets.clear();
+
+    BufferInputSource input("", decoded.data.get());
+
+    const auto b_size = decoded.data->getSize();
     const auto end_offset = static_cast<qpdf_offset_t>(b_size);
-    auto b_start = bp->getBuffer();
 
     if (first >= end_offset) {
         throw damagedPDF(
@@ -1666,8 +1851,8 @@ QPDF::resolveObjectsInStream(int obj_stream_number)
     long long last_offset = -1;
     bool is_first = true;
     for (unsigned int i = 0; i < n; ++i) {
-        auto tnum = readToken(input);
-        auto toffset = readToken(input);
+        auto tnum = tokenizer.readToken(input, "", true);
+        auto toffset = tokenizer.readToken(input, "", true);
         if (!(tnum.isInteger() && toffset.isInteger())) {
             throw damaged(0, input.getLastOffset(), "expected integer in object stream header");
         }
@@ -1677,19 +1862,19 @@ QPDF::resolveObjectsInStream(int obj_stream_number)
 
         if (num == obj_stream_number) {
             QTC::TC("qpdf", "QPDF ignore self-referential object stream");
-            warn(damaged(num, input.getLastOffset(), "object stream claims to contain itself"));
+            warn_fn(damaged(num, input.getLastOffset(), "object stream claims to contain itself"));
             continue;
         }
 
         if (num < 1) {
             QTC::TC("qpdf", "QPDF object stream contains id < 1");
-            warn(damaged(num, input.getLastOffset(), "object id is invalid"s));
+            warn_fn(damaged(num, input.getLastOffset(), "object id is invalid"s));
             continue;
         }
 
         if (offset <= last_offset) {
             QTC::TC("qpdf", "QPDF object stream offsets not increasing");
-            warn(damaged(
+            warn_fn(damaged(
                 num,
                 offset,
                 "offset is invalid (must be larger than previous offset " +
@@ -1702,7 +1887,7 @@ QPDF::resolveObjectsInStream(int obj_stream_number)
         }
 
         if (first + offset >= end_offset) {
-            warn(damaged(num, offset, "offset is too large"));
+            warn_fn(damaged(num, offset, "offset is too large"));
             continue;
         }
 
@@ -1722,23 +1907,140 @@ QPDF::resolveObjectsInStream(int obj_stream_number)
         offsets.emplace_back(
             id, last_offset + first, b_size - static_cast<size_t>(last_offset + first));
     }
+    decoded.header_read = true;
+}
 
-    // To avoid having to read the object stream multiple times, store all objects that would be
-    // found here in the cache.  Remember that some objects stored here might have been overridden
-    // by new objects appended to the file, so it is necessary to recheck the xref table and only
-    // cache what would actually be resolved here.
-    for (auto const& [obj_id, obj_offset, obj_size]: offsets) {
-        QPDFObjGen og(obj_id, 0);
-        auto entry = m->xref_table.find(og);
-        if (entry != m->xref_table.end() && entry->second.getType() == 2 &&
-            entry->second.getObjStreamNumber() == obj_stream_number) {
-            Buffer obj_buffer{b_start + obj_offset, obj_size};
-            is::OffsetBuffer in("", &obj_buffer, obj_offset);
-            auto oh = readObjectInStream(in, obj_stream_number, obj_id);
-            updateCache(og, oh.getObj(), end_before_space, end_after_space);
-        } else {
-            QTC::TC("qpdf", "QPDF not caching overridden objstm object");
+void
+QPDF::decodeObjectStreams(int obj_stream_number)
+{
+    // Read the raw data of obj_stream_number and of the object streams that follow it until enough
+    // data is buffered. Then inflate the data and read the object stream headers on multiple
+    // threads. Object streams that can't be handled here, or whose decoding causes warnings, are
+    // left to resolveObjectsInStream, which decodes them itself and issues the warnings. Decoded
+    // object streams that have not been used yet are limited to about max_bytes in total; if
+    // there are more, those with the lowest numbers are dropped and decoded again when needed.
+    static size_t const max_bytes_per_job = 16 * 1024 * 1024;
+    size_t const max_bytes = m->object_stream_jobs * max_bytes_per_job;
+    auto& held = m->decoded_object_streams;
+    for (auto it = held.begin();
+         it != held.end() && m->decoded_object_streams_bytes >= max_bytes;) {
+        m->decoded_object_streams_bytes -= it->second.data->getSize();
+        it = held.erase(it);
+    }
+
+    if (!m->object_streams_to_decode) {
+        m->object_streams_to_decode.emplace();
+        for (auto const& [og, entry]: m->xref_table) {
+            if (entry.getType() == 2) {
+                m->object_streams_to_decode->insert(entry.getObjStreamNumber());
+            }
+        }
+    }
+    auto& to_decode = *m->object_streams_to_decode;
+
+    struct Job
+    {
+        int number;
+        unsigned int n;
+        int first;
+        std::string raw;
+        DecodedObjectStream decoded;
+        bool ok{false};
+    };
+    std::vector<Job> jobs;
+    size_t total_bytes = m->decoded_object_streams_bytes;
+
+    for (auto it = to_decode.lower_bound(obj_stream_number);
+         it != to_decode.end() && total_bytes < max_bytes;) {
+        int number = *it;
+        it = to_decode.erase(it);
+        if (number != obj_stream_number &&
+            (m->resolved_object_streams.count(number) ||
+             m->decoded_object_streams.count(number))) {
+            continue;
+        }
+        auto stream = getObject(number, 0).as_stream();
+        if (!stream) {
+            continue;
+        }
+        auto dict = stream.getDict();
+        auto filter = dict.getKey("/Filter");
+        if (filter.isArray() && filter.getArrayNItems() == 1) {
+            filter = filter.getArrayItem(0);
+        }
+        unsigned int n{0};
+        int first{0};
+        if (!(dict.isDictionaryOfType("/ObjStm") && dict.getKey("/N").getValueAsUInt(n) &&
+              dict.getKey("/First").getValueAsInt(first) &&
+              filter.isNameAndEquals("/FlateDecode") && dict.getKey("/DecodeParms").isNull())) {
+            continue;
+        }
+        Job job{number, n, first, {}, {}};
+        Pl_String raw("raw object stream", nullptr, job.raw);
+        if (!stream.pipeStreamData(&raw, nullptr, 0, qpdf_dl_none, true, false)) {
+            continue;
+        }
+        total_bytes += job.raw.size();
+        jobs.emplace_back(std::move(job));
+    }
+
+    if (jobs.empty()) {
+        return;
+    }
+    QTC::TC("qpdf", "QPDF decode object streams in parallel", jobs.size() > 1 ? 1 : 0);
+    std::atomic<size_t> next_job{0};
+    auto worker = [this, &jobs, &next_job]() {
+        qpdf::Tokenizer tokenizer;
+        tokenizer.allowEOF();
+        for (size_t i; (i = next_job++) < jobs.size();) {
+            auto& job = jobs.at(i);
+            try {
+                std::string data;
+                Pl_String out("decoded object stream", nullptr, data);
+                Pl_Flate flate("object stream", &out, Pl_Flate::a_inflate);
+                bool warned = false;
+                flate.setWarnCallback([&warned](char const*, int) { warned = true; });
+                flate.writeString(job.raw);
+                flate.finish();
+                job.raw.clear();
+                job.raw.shrink_to_fit();
+                if (warned) {
+                    continue;
+                }
+                job.decoded.data = std::make_shared<Buffer>(std::move(data));
+                job.ok = true;
+                readObjectStreamHeader(
+                    tokenizer, job.number, job.n, job.first, job.decoded, [](QPDFExc&& e) {
+                        throw std::move(e);
+                    });
+            } catch (std::exception&) {
+                // Leave it to resolveObjectsInStream to report the problem.
+                job.decoded.offsets.clear();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(m->object_stream_jobs, jobs.size()); ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& t: threads) {
+        t.join();
+    }
+
+    // Keep obj_stream_number, which is used right away, and as many of the following object
+    // streams as fit.
+    for (auto& job: jobs) {
+        if (!job.ok) {
+            continue;
+        }
+        auto size = job.decoded.data->getSize();
+        if (job.number != obj_stream_number &&
+            m->decoded_object_streams_bytes + size > max_bytes) {
+            continue;
         }
+        m->decoded_object_streams_bytes += size;
+        held.emplace(job.number, std::move(job.decoded));
     }
 }
 
@@ -1812,29 +2114,30 @@ QPDF::getObjectForParser(int id, int gen, bool parse_pdf)
 {
     // This method is called by the parser and therefore must not resolve any objects.
     auto og = QPDFObjGen(id, gen);
-    if (auto iter = m->obj_cache.find(og); iter != m->obj_cache.end()) {
-        return iter->second.object;
+    if (auto cached = m->obj_cache.get(og)) {
+        return cached->object;
     }
     if (m->xref_table.count(og) || !m->parsed) {
-        return m->obj_cache.insert({og, QPDFObject::create<QPDF_Unresolved>(this, og)})
-            .first->second.object;
+        return m->obj_cache
+            .try_emplace(og, QPDFObject::create_pooled<QPDF_Unresolved>(m->object_pool, this, og))
+            .first.object;
     }
     if (parse_pdf) {
         return QPDFObject::create<QPDF_Null>();
     }
-    return m->obj_cache.insert({og, QPDFObject::create<QPDF_Null>(this, og)}).first->second.object;
+    return m->obj_cache.try_emplace(og, QPDFObject::create<QPDF_Null>(this, og)).first.object;
 }
 
 std::shared_ptr<QPDFObject>
 QPDF::getObjectForJSON(int id, int gen)
 {
     auto og = QPDFObjGen(id, gen);
-    auto [it, inserted] = m->obj_cache.try_emplace(og);
-    auto& obj = it->second.object;
+    auto [cached, inserted] = m->obj_cache.try_emplace(og);
+    auto& obj = cached.object;
     if (inserted) {
         obj = (m->parsed && !m->xref_table.count(og))
             ? QPDFObject::create<QPDF_Null>(this, og)
-            : QPDFObject::create<QPDF_Unresolved>(this, og);
+            : QPDFObject::create_pooled<QPDF_Unresolved>(m->object_pool, this, og);
     }
     return obj;
 }
@@ -1842,14 +2145,14 @@ QPDF::getObjectForJSON(int id, int gen)
 QPDFObjectHandle
 QPDF::getObject(QPDFObjGen og)
 {
-    if (auto it = m->obj_cache.find(og); it != m->obj_cache.end()) {
-        return {it->second.object};
+    if (auto cached = m->obj_cache.get(og)) {
+        return {cached->object};
     } else if (m->parsed && !m->xref_table.count(og)) {
         return QPDFObject::create<QPDF_Null>();
     } else {
-        auto result =
-            m->obj_cache.try_emplace(og, QPDFObject::create<QPDF_Unresolved>(this, og), -1, -1);
-        return {result.first->second.object};
+        auto result = m->obj_cache.try_emplace(
+            og, QPDFObject::create_pooled<QPDF_Unresolved>(m->object_pool, this, og), -1, -1);
+        return {result.first.object};
     }
 }
 
@@ -1873,11 +2176,11 @@ void
 QPDF::removeObject(QPDFObjGen og)
 {
     m->xref_table.erase(og);
-    if (auto cached = m->obj_cache.find(og); cached != m->obj_cache.end()) {
+    if (auto cached = m->obj_cache.get(og)) {
         // Take care of any object handles that may be floating around.
-        cached->second.object->assign_null();
-        cached->second.object->setObjGen(nullptr, QPDFObjGen());
-        m->obj_cache.erase(cached);
+        cached->object->assign_null();
+        cached->object->setObjGen(nullptr, QPDFObjGen());
+        m->obj_cache.erase(og);
     }
 }
 
@@ -1912,8 +2215,8 @@ QPDF::tableSize()
 {
     // If obj_cache is dense, accommodate all object in tables,else accommodate only original
     // objects.
-    auto max_xref = m->xref_table.size() ? m->xref_table.crbegin()->first.getObj() : 0;
-    auto max_obj = m->obj_cache.size() ? m->obj_cache.crbegin()->first.getObj() : 0;
+    auto max_xref = m->xref_table.last().getObj();
+    auto max_obj = m->obj_cache.last().getObj();
     auto max_id = std::numeric_limits<int>::max() - 1;
     if (max_obj >= max_id || max_xref >= max_id) {
         // Temporary fix. Long-term solution is
@@ -1984,8 +2287,7 @@ QPDF::getCompressibleObjGens()
             // Check whether this is the current object. If not, remove it (which changes it into a
             // direct null and therefore stops us from revisiting it) and move on to the next object
             // in the queue.
-            auto upper = m->obj_cache.upper_bound(og);
-            if (upper != m->obj_cache.end() && upper->first.getObj() == og.getObj()) {
+            if (m->obj_cache.has_later_generation(og)) {
                 removeObject(og);
                 continue;
             }
@@ -276,6 +276,40 @@ QPDF::pushInheritedAttributesToPageInternal(
     }
 }
 
+void
+QPDF::pushInheritedAttributesToOnePage(QPDFObjectHandle page)
+{
+    // Give page its own value for each attribute it inherits, leaving the pages tree otherwise
+    // unchanged. Unlike pushInheritedAttributesToPage, this only follows the page's /Parent chain,
+    // so it doesn't have to enumerate the pages of a large file to copy a few of them.
+    if (m->pushed_inherited_attributes_to_pages) {
+        return;
+    }
+    for (auto key: {"/MediaBox", "/CropBox", "/Resources", "/Rotate"}) {
+        if (page.hasKey(key)) {
+            continue;
+        }
+        QPDFObjectHandle node = page;
+        QPDFObjGen::set seen;
+        while (seen.add(node) && node.hasKey("/Parent")) {
+            node = node.getKey("/Parent");
+            QPDFObjectHandle oh = node.getKey(key);
+            if (oh.null()) {
+                continue;
+            }
+            QTC::TC("qpdf", "QPDF opt resource inherited by one page");
+            if (!oh.isIndirect() && !oh.isScalar()) {
+                // As in pushInheritedAttributesToPageInternal, share non-scalar values through an
+                // indirect object rather than copying them to each page.
+                oh = makeIndirectObject(oh);
+                node.replaceKey(key, oh);
+            }
+            page.replaceKey(key, oh);
+            break;
+        }
+    }
+}
+
 void
 QPDF::updateObjectMaps(
     ObjUser const& first_ou,
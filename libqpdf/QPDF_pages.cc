@@ -43,6 +43,7 @@ QPDF::getAllPages()
     // Note that pushInheritedAttributesToPage may also be used to initialize m->all_pages.
     if (m->all_pages.empty() && !m->invalid_page_found) {
         m->ever_called_get_all_pages = true;
+        m->valid_page_nodes.clear();
         QPDFObjGen::set visited;
         QPDFObjGen::set seen;
         QPDFObjectHandle pages = getRoot().getKey("/Pages");
@@ -88,6 +89,145 @@ QPDF::getAllPages()
     return m->all_pages;
 }
 
+namespace
+{
+    // Check that node is a well-formed intermediate node of the pages tree: /Type is /Pages, /Count
+    // is the sum of the page counts of its kids, and every kid is either such a node or an indirect
+    // /Page dictionary. Set count to /Count. If n < count, set kid to the kid containing page n and
+    // make n relative to it. Return false if the node is not well-formed. If validated is true, the
+    // node is known to be well-formed, so only the kids up to the one containing page n are looked
+    // at.
+    bool
+    find_page_kid(
+        QPDFObjectHandle node, size_t& n, size_t& count, QPDFObjectHandle& kid, bool validated)
+    {
+        long long node_count = 0;
+        if (!validated &&
+            (!node.isDictionaryOfType("/Pages") || !node.getKey("/Kids").isArray() ||
+             !node.getKey("/Count").getValueAsInt(node_count) || node_count < 0)) {
+            return false;
+        }
+        if (validated) {
+            node_count = node.getKey("/Count").getIntValue();
+        }
+        count = QIntC::to_size(node_count);
+        if (validated && n >= count) {
+            return true;
+        }
+        size_t total = 0;
+        bool found = false;
+        for (auto const& k: node.getKey("/Kids").as_array()) {
+            long long kid_count = 1;
+            if (validated) {
+                if (k.hasKey("/Kids")) {
+                    kid_count = k.getKey("/Count").getIntValue();
+                }
+            } else {
+                if (!k.isDictionary()) {
+                    return false;
+                }
+                if (k.hasKey("/Kids")) {
+                    if (!k.isDictionaryOfType("/Pages") ||
+                        !k.getKey("/Count").getValueAsInt(kid_count) || kid_count < 0) {
+                        return false;
+                    }
+                } else if (!k.isIndirect() || !k.isDictionaryOfType("/Page")) {
+                    return false;
+                }
+            }
+            if (!found && n < total + QIntC::to_size(kid_count)) {
+                found = true;
+                kid = k;
+                n -= total;
+                if (validated) {
+                    return true;
+                }
+            }
+            total += QIntC::to_size(kid_count);
+        }
+        return total == count;
+    }
+
+    // As find_page_kid, but remember in valid which nodes were found well-formed so that each of
+    // them is only checked once.
+    bool
+    find_page_kid(
+        QPDFObjectHandle node,
+        size_t& n,
+        size_t& count,
+        QPDFObjectHandle& kid,
+        std::set<QPDFObjGen>& valid)
+    {
+        auto og = node.getObjGen();
+        bool indirect = node.isIndirect();
+        if (indirect && valid.count(og)) {
+            QTC::TC("qpdf", "QPDF getPage validated node");
+            return find_page_kid(node, n, count, kid, true);
+        }
+        if (!find_page_kid(node, n, count, kid, false)) {
+            return false;
+        }
+        if (indirect) {
+            valid.insert(og);
+        }
+        return true;
+    }
+} // namespace
+
+size_t
+QPDF::getPageCount()
+{
+    if (m->all_pages.empty()) {
+        size_t n = 0;
+        size_t count = 0;
+        QPDFObjectHandle kid;
+        auto pages = getRoot().getKey("/Pages");
+        if (pages.isDictionary() && !pages.hasKey("/Parent") &&
+            find_page_kid(pages, n, count, kid, m->valid_page_nodes)) {
+            QTC::TC("qpdf", "QPDF getPageCount from /Count");
+            return count;
+        }
+    }
+    return getAllPages().size();
+}
+
+QPDFObjectHandle
+QPDF::getPage(size_t n)
+{
+    if (m->all_pages.empty()) {
+        QPDFObjGen::set visited;
+        auto node = getRoot().getKey("/Pages");
+        bool media_box = false;
+        size_t i = n;
+        size_t count = 0;
+        // As in getAllPages, a root with a /Parent is not really the root of the pages tree.
+        bool descend = node.isDictionary() && !node.hasKey("/Parent");
+        while (descend && visited.add(node)) {
+            QPDFObjectHandle kid;
+            media_box = media_box || node.getKey("/MediaBox").isRectangle();
+            if (!find_page_kid(node, i, count, kid, m->valid_page_nodes)) {
+                break;
+            }
+            if (i >= count) {
+                QTC::TC("qpdf", "QPDF getPage out of range");
+                return QPDFObjectHandle::newNull();
+            }
+            if (!kid.hasKey("/Kids")) {
+                if (!media_box && !kid.getKey("/MediaBox").isRectangle()) {
+                    // getAllPages will supply a default /MediaBox.
+                    break;
+                }
+                QTC::TC("qpdf", "QPDF getPage from /Count");
+                return kid;
+            }
+            node = kid;
+        }
+        QTC::TC("qpdf", "QPDF getPage fallback");
+    }
+    auto const& pages = getAllPages();
+    return n < pages.size() ? pages.at(n) : QPDFObjectHandle::newNull();
+}
+
 void
 QPDF::getAllPagesInternal(
     QPDFObjectHandle cur_node, QPDFObjGen::set& visited, QPDFObjGen::set& seen, bool media_box)
@@ -234,7 +374,7 @@ QPDF::insertPage(QPDFObjectHandle newpage, int pos)
         newpage = makeIndirectObject(newpage);
     } else if (newpage.getOwningQPDF() != this) {
         QTC::TC("qpdf", "QPDF insert foreign page");
-        newpage.getQPDF().pushInheritedAttributesToPage();
+        newpage.getQPDF().pushInheritedAttributesToOnePage(newpage);
         newpage = copyForeignObject(newpage);
     } else {
         QTC::TC("qpdf", "QPDF insert indirect page");
@@ -3,6 +3,7 @@
 #include <qpdf/QUtil.hh>
 #include <cstdio>
 #include <map>
+#include <mutex>
 #include <set>
 
 static bool
@@ -15,6 +16,9 @@ tc_active(char const* const scope)
 void
 QTC::TC_real(char const* const scope, char const* const ccase, int n)
 {
+    // Coverage cases may be hit from worker threads, such as when splitting pages in parallel.
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
     static std::map<std::string, bool> active;
     auto is_active = active.find(scope);
     if (is_active == active.end()) {
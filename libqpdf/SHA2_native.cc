@@ -1,8 +1,30 @@
 #include <qpdf/SHA2_native.hh>
 
+#include <qpdf/QIntC.hh>
 #include <qpdf/QUtil.hh>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <stdexcept>
+#include <vector>
+
+// SHA and AVX2 instructions are used to hash several messages at once if the CPU has them. They are
+// checked for at run time, so the compiler doesn't have to target them.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# include <cpuid.h>
+# include <immintrin.h>
+# define QPDF_SHA2_SIMD
+# define QPDF_SHA_NI_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+# define QPDF_SHA2_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <immintrin.h>
+# include <intrin.h>
+# define QPDF_SHA2_SIMD
+# define QPDF_SHA_NI_TARGET
+# define QPDF_SHA2_AVX2_TARGET
+#endif
 
 SHA2_native::SHA2_native(int bits) :
     bits(bits)
@@ -87,3 +109,525 @@ SHA2_native::getRawDigest()
     }
     return result;
 }
+
+#ifdef QPDF_SHA2_SIMD
+namespace
+{
+    uint32_t const H256[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab,
+        0x5be0cd19};
+
+    uint64_t const H384[8] = {
+        0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+        0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4};
+
+    uint64_t const H512[8] = {
+        0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+        0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
+
+    uint32_t const K256[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+        0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+        0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+        0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+        0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+        0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+        0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+        0xc67178f2};
+
+    uint64_t const K512[80] = {
+        0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+        0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+        0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+        0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+        0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+        0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+        0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+        0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+        0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+        0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+        0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+        0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+        0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+        0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+        0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+        0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+        0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+        0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+        0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+        0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817};
+
+    // Messages that have no block left to process are given zeros instead.
+    unsigned char const zero_block[128] = {};
+
+    // A message and its padding as a sequence of blocks of B bytes. The blocks that are all data
+    // are read from the message itself. The rest of the data and the padding are copied to tail.
+    template <size_t B>
+    struct Message
+    {
+        void
+        init(size_t index, unsigned char const* data, size_t len)
+        {
+            this->index = index;
+            this->data = data;
+            full_blocks = len / B;
+            size_t rest = len % B;
+            // The padding is a one bit, zeros, and the length in bits, which takes an eighth of a
+            // block. Lengths don't exceed 64 bits here.
+            blocks = full_blocks + ((rest + 1 + B / 8 <= B) ? 1 : 2);
+            std::memset(tail, 0, sizeof(tail));
+            if (rest) {
+                std::memcpy(tail, data + full_blocks * B, rest);
+            }
+            tail[rest] = 0x80;
+            unsigned char* end = tail + (blocks - full_blocks) * B;
+            uint64_t bits = static_cast<uint64_t>(len) << 3;
+            for (size_t i = 0; i < 8; ++i) {
+                end[-1 - static_cast<ptrdiff_t>(i)] = static_cast<unsigned char>(bits >> (8 * i));
+            }
+        }
+
+        unsigned char const*
+        block(size_t i) const
+        {
+            return i < full_blocks ? data + i * B
+                : i < blocks       ? tail + (i - full_blocks) * B
+                                   : zero_block;
+        }
+
+        size_t index;
+        unsigned char const* data;
+        size_t full_blocks;
+        size_t blocks;
+        unsigned char tail[2 * B];
+    };
+
+    // Setting QPDF_SHA_NI or QPDF_SHA2_AVX2 to "disabled" prevents the use of those instructions
+    // so that the other implementations can be tested on CPUs that have them.
+    bool
+    disabled(char const* var)
+    {
+        std::string value;
+        return QUtil::get_env(var, &value) && value == "disabled";
+    }
+
+    bool
+    sha_ni_supported()
+    {
+        static bool const supported = []() {
+            if (disabled("QPDF_SHA_NI")) {
+                return false;
+            }
+# ifdef _MSC_VER
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            bool sse = (info[2] & (1 << 9)) != 0 && (info[2] & (1 << 19)) != 0;
+            __cpuidex(info, 7, 0);
+            return sse && (info[1] & (1 << 29)) != 0;
+# else
+            unsigned int a = 0, b = 0, c = 0, d = 0;
+            return __get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & (1U << 29)) != 0 &&
+                __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+# endif
+        }();
+        return supported;
+    }
+
+    bool
+    avx2_supported()
+    {
+        static bool const supported = []() {
+            if (disabled("QPDF_SHA2_AVX2")) {
+                return false;
+            }
+# ifdef _MSC_VER
+            // AVX2 registers can only be used if the operating system saves them.
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 ||
+                (_xgetbv(0) & 6) != 6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+# else
+            return __builtin_cpu_supports("avx2") != 0;
+# endif
+        }();
+        return supported;
+    }
+
+    // Hash N messages side by side with the SHA instructions, which keep the state as ABEF and
+    // CDGH. Interleaving the messages hides the latency of the instructions.
+    template <size_t N>
+    QPDF_SHA_NI_TARGET void
+    ni_sha256(Message<64> const* msgs, std::array<uint32_t, 8>* states)
+    {
+        __m128i const bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+        __m128i abef[N];
+        __m128i cdgh[N];
+        size_t blocks = 0;
+        for (size_t l = 0; l < N; ++l) {
+            __m128i dcba = _mm_loadu_si128(reinterpret_cast<__m128i const*>(states[l].data()));
+            __m128i hgfe = _mm_loadu_si128(reinterpret_cast<__m128i const*>(states[l].data() + 4));
+            __m128i cdab = _mm_shuffle_epi32(dcba, 0xb1);
+            __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+            abef[l] = _mm_alignr_epi8(cdab, efgh, 8);
+            cdgh[l] = _mm_blend_epi16(efgh, cdab, 0xf0);
+            blocks = std::max(blocks, msgs[l].blocks);
+        }
+        for (size_t j = 0; j < blocks; ++j) {
+            __m128i abef_save[N];
+            __m128i cdgh_save[N];
+            __m128i w[N][4];
+            for (size_t l = 0; l < N; ++l) {
+                abef_save[l] = abef[l];
+                cdgh_save[l] = cdgh[l];
+                auto block = msgs[l].block(j);
+                for (size_t i = 0; i < 4; ++i) {
+                    w[l][i] = _mm_shuffle_epi8(
+                        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16 * i)), bswap);
+                }
+            }
+            // Each step does four rounds using four words of the message schedule.
+            for (size_t r = 0; r < 16; ++r) {
+                __m128i k = _mm_loadu_si128(reinterpret_cast<__m128i const*>(K256 + 4 * r));
+                for (size_t l = 0; l < N; ++l) {
+                    __m128i* m = w[l];
+                    if (r >= 4) {
+                        m[r % 4] = _mm_sha256msg2_epu32(
+                            _mm_add_epi32(
+                                _mm_sha256msg1_epu32(m[r % 4], m[(r + 1) % 4]),
+                                _mm_alignr_epi8(m[(r + 3) % 4], m[(r + 2) % 4], 4)),
+                            m[(r + 3) % 4]);
+                    }
+                    __m128i x = _mm_add_epi32(m[r % 4], k);
+                    cdgh[l] = _mm_sha256rnds2_epu32(cdgh[l], abef[l], x);
+                    abef[l] = _mm_sha256rnds2_epu32(abef[l], cdgh[l], _mm_shuffle_epi32(x, 0x0e));
+                }
+            }
+            for (size_t l = 0; l < N; ++l) {
+                if (j < msgs[l].blocks) {
+                    abef[l] = _mm_add_epi32(abef[l], abef_save[l]);
+                    cdgh[l] = _mm_add_epi32(cdgh[l], cdgh_save[l]);
+                } else {
+                    abef[l] = abef_save[l];
+                    cdgh[l] = cdgh_save[l];
+                }
+            }
+        }
+        for (size_t l = 0; l < N; ++l) {
+            __m128i feba = _mm_shuffle_epi32(abef[l], 0x1b);
+            __m128i dchg = _mm_shuffle_epi32(cdgh[l], 0xb1);
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(states[l].data()), _mm_blend_epi16(feba, dchg, 0xf0));
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(states[l].data() + 4), _mm_alignr_epi8(dchg, feba, 8));
+        }
+    }
+
+    template <int n>
+    QPDF_SHA2_AVX2_TARGET __m256i
+    rotr32(__m256i x)
+    {
+        return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+    }
+
+    template <int n>
+    QPDF_SHA2_AVX2_TARGET __m256i
+    rotr64(__m256i x)
+    {
+        return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n));
+    }
+
+    // Hash up to eight messages side by side with AVX2 instructions. Lane l of s[i] holds word i
+    // of the state of message l, and lane l of w[t] holds word t of its current block.
+    QPDF_SHA2_AVX2_TARGET void
+    avx2_sha256(Message<64> const* msgs, size_t n, std::array<uint32_t, 8>* states)
+    {
+        __m256i const bswap = _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        __m256i s[8];
+        size_t blocks = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            alignas(32) uint32_t lanes[8] = {};
+            for (size_t l = 0; l < n; ++l) {
+                lanes[l] = states[l][i];
+            }
+            s[i] = _mm256_load_si256(reinterpret_cast<__m256i const*>(lanes));
+        }
+        for (size_t l = 0; l < n; ++l) {
+            blocks = std::max(blocks, msgs[l].blocks);
+        }
+        for (size_t j = 0; j < blocks; ++j) {
+            alignas(32) uint32_t active[8] = {};
+            __m256i w[16];
+            for (size_t half = 0; half < 2; ++half) {
+                __m256i r[8];
+                for (size_t l = 0; l < 8; ++l) {
+                    auto block = l < n ? msgs[l].block(j) : zero_block;
+                    r[l] = _mm256_shuffle_epi8(
+                        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + 32 * half)),
+                        bswap);
+                }
+                // Transpose the rows of eight words so that each vector holds one word of every
+                // message.
+                __m256i t[8];
+                for (size_t i = 0; i < 8; i += 2) {
+                    t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+                    t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+                }
+                __m256i u[8];
+                for (size_t i = 0; i < 8; i += 4) {
+                    u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+                    u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+                    u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+                    u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+                }
+                for (size_t i = 0; i < 4; ++i) {
+                    w[8 * half + i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+                    w[8 * half + i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+                }
+            }
+            for (size_t l = 0; l < n; ++l) {
+                active[l] = (j < msgs[l].blocks) ? 0xffffffff : 0;
+            }
+            __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+            for (size_t t = 0; t < 64; ++t) {
+                __m256i& wt = w[t % 16];
+                if (t >= 16) {
+                    __m256i w2 = w[(t - 2) % 16];
+                    __m256i w15 = w[(t - 15) % 16];
+                    __m256i sigma1 = _mm256_xor_si256(
+                        _mm256_xor_si256(rotr32<17>(w2), rotr32<19>(w2)),
+                        _mm256_srli_epi32(w2, 10));
+                    __m256i sigma0 = _mm256_xor_si256(
+                        _mm256_xor_si256(rotr32<7>(w15), rotr32<18>(w15)),
+                        _mm256_srli_epi32(w15, 3));
+                    wt = _mm256_add_epi32(
+                        _mm256_add_epi32(wt, sigma0), _mm256_add_epi32(sigma1, w[(t - 7) % 16]));
+                }
+                __m256i big_sigma1 =
+                    _mm256_xor_si256(_mm256_xor_si256(rotr32<6>(e), rotr32<11>(e)), rotr32<25>(e));
+                __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                __m256i t1 = _mm256_add_epi32(
+                    _mm256_add_epi32(_mm256_add_epi32(h, big_sigma1), ch),
+                    _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(K256[t])), wt));
+                __m256i big_sigma0 =
+                    _mm256_xor_si256(_mm256_xor_si256(rotr32<2>(a), rotr32<13>(a)), rotr32<22>(a));
+                __m256i maj = _mm256_or_si256(
+                    _mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+                h = g;
+                g = f;
+                f = e;
+                e = _mm256_add_epi32(d, t1);
+                d = c;
+                c = b;
+                b = a;
+                a = _mm256_add_epi32(t1, _mm256_add_epi32(big_sigma0, maj));
+            }
+            __m256i mask = _mm256_load_si256(reinterpret_cast<__m256i const*>(active));
+            __m256i x[8] = {a, b, c, d, e, f, g, h};
+            for (size_t i = 0; i < 8; ++i) {
+                s[i] = _mm256_blendv_epi8(s[i], _mm256_add_epi32(s[i], x[i]), mask);
+            }
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            alignas(32) uint32_t lanes[8];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), s[i]);
+            for (size_t l = 0; l < n; ++l) {
+                states[l][i] = lanes[l];
+            }
+        }
+    }
+
+    // Hash up to four messages side by side with AVX2 instructions. This works like avx2_sha256.
+    QPDF_SHA2_AVX2_TARGET void
+    avx2_sha512(Message<128> const* msgs, size_t n, std::array<uint64_t, 8>* states)
+    {
+        __m256i const bswap = _mm256_setr_epi8(
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        __m256i s[8];
+        size_t blocks = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            alignas(32) uint64_t lanes[4] = {};
+            for (size_t l = 0; l < n; ++l) {
+                lanes[l] = states[l][i];
+            }
+            s[i] = _mm256_load_si256(reinterpret_cast<__m256i const*>(lanes));
+        }
+        for (size_t l = 0; l < n; ++l) {
+            blocks = std::max(blocks, msgs[l].blocks);
+        }
+        for (size_t j = 0; j < blocks; ++j) {
+            alignas(32) uint64_t active[4] = {};
+            __m256i w[16];
+            for (size_t quarter = 0; quarter < 4; ++quarter) {
+                __m256i r[4];
+                for (size_t l = 0; l < 4; ++l) {
+                    auto block = l < n ? msgs[l].block(j) : zero_block;
+                    r[l] = _mm256_shuffle_epi8(
+                        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + 32 * quarter)),
+                        bswap);
+                }
+                __m256i t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+                __m256i t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+                __m256i t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+                __m256i t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+                w[4 * quarter] = _mm256_permute2x128_si256(t0, t2, 0x20);
+                w[4 * quarter + 1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+                w[4 * quarter + 2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+                w[4 * quarter + 3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+            }
+            for (size_t l = 0; l < n; ++l) {
+                active[l] = (j < msgs[l].blocks) ? ~uint64_t(0) : 0;
+            }
+            __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+            for (size_t t = 0; t < 80; ++t) {
+                __m256i& wt = w[t % 16];
+                if (t >= 16) {
+                    __m256i w2 = w[(t - 2) % 16];
+                    __m256i w15 = w[(t - 15) % 16];
+                    __m256i sigma1 = _mm256_xor_si256(
+                        _mm256_xor_si256(rotr64<19>(w2), rotr64<61>(w2)),
+                        _mm256_srli_epi64(w2, 6));
+                    __m256i sigma0 = _mm256_xor_si256(
+                        _mm256_xor_si256(rotr64<1>(w15), rotr64<8>(w15)),
+                        _mm256_srli_epi64(w15, 7));
+                    wt = _mm256_add_epi64(
+                        _mm256_add_epi64(wt, sigma0), _mm256_add_epi64(sigma1, w[(t - 7) % 16]));
+                }
+                __m256i big_sigma1 =
+                    _mm256_xor_si256(_mm256_xor_si256(rotr64<14>(e), rotr64<18>(e)), rotr64<41>(e));
+                __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+                __m256i t1 = _mm256_add_epi64(
+                    _mm256_add_epi64(_mm256_add_epi64(h, big_sigma1), ch),
+                    _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(K512[t])), wt));
+                __m256i big_sigma0 =
+                    _mm256_xor_si256(_mm256_xor_si256(rotr64<28>(a), rotr64<34>(a)), rotr64<39>(a));
+                __m256i maj = _mm256_or_si256(
+                    _mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+                h = g;
+                g = f;
+                f = e;
+                e = _mm256_add_epi64(d, t1);
+                d = c;
+                c = b;
+                b = a;
+                a = _mm256_add_epi64(t1, _mm256_add_epi64(big_sigma0, maj));
+            }
+            __m256i mask = _mm256_load_si256(reinterpret_cast<__m256i const*>(active));
+            __m256i x[8] = {a, b, c, d, e, f, g, h};
+            for (size_t i = 0; i < 8; ++i) {
+                s[i] = _mm256_blendv_epi8(s[i], _mm256_add_epi64(s[i], x[i]), mask);
+            }
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), s[i]);
+            for (size_t l = 0; l < n; ++l) {
+                states[l][i] = lanes[l];
+            }
+        }
+    }
+
+    // Set up the messages in order of their number of blocks so that messages that are hashed
+    // side by side need about the same number of steps.
+    template <size_t B>
+    std::vector<Message<B>>
+    sorted_messages(size_t count, unsigned char const* const* in_data, size_t const* lens)
+    {
+        std::vector<Message<B>> msgs(count);
+        for (size_t i = 0; i < count; ++i) {
+            msgs[i].init(i, in_data[i], lens[i]);
+        }
+        std::stable_sort(msgs.begin(), msgs.end(), [](Message<B> const& a, Message<B> const& b) {
+            return a.blocks < b.blocks;
+        });
+        return msgs;
+    }
+
+    template <typename T>
+    void
+    write_digest(T const* state, size_t bytes, unsigned char* out)
+    {
+        for (size_t i = 0; i < bytes; ++i) {
+            out[i] = static_cast<unsigned char>(
+                state[i / sizeof(T)] >> (8 * (sizeof(T) - 1 - i % sizeof(T))));
+        }
+    }
+} // namespace
+#endif
+
+void
+SHA2_native::batch(
+    int bits,
+    size_t count,
+    unsigned char const* const* in_data,
+    size_t const* lens,
+    unsigned char* const* out_data)
+{
+    if (bits != 256 && bits != 384 && bits != 512) {
+        badBits();
+    }
+#ifdef QPDF_SHA2_SIMD
+    if (bits == 256 && (sha_ni_supported() || (count > 1 && avx2_supported()))) {
+        auto msgs = sorted_messages<64>(count, in_data, lens);
+        std::vector<std::array<uint32_t, 8>> states(count);
+        for (auto& state: states) {
+            std::copy(H256, H256 + 8, state.begin());
+        }
+        if (sha_ni_supported()) {
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                ni_sha256<2>(msgs.data() + i, states.data() + i);
+            }
+            if (i < count) {
+                ni_sha256<1>(msgs.data() + i, states.data() + i);
+            }
+        } else {
+            for (size_t i = 0; i < count; i += 8) {
+                avx2_sha256(msgs.data() + i, std::min<size_t>(8, count - i), states.data() + i);
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            write_digest(states[i].data(), 32, out_data[msgs[i].index]);
+        }
+        return;
+    }
+    if (bits != 256 && count > 1 && avx2_supported()) {
+        auto msgs = sorted_messages<128>(count, in_data, lens);
+        uint64_t const* h = (bits == 384) ? H384 : H512;
+        std::vector<std::array<uint64_t, 8>> states(count);
+        for (auto& state: states) {
+            std::copy(h, h + 8, state.begin());
+        }
+        for (size_t i = 0; i < count; i += 4) {
+            avx2_sha512(msgs.data() + i, std::min<size_t>(4, count - i), states.data() + i);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            write_digest(states[i].data(), QIntC::to_size(bits / 8), out_data[msgs[i].index]);
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        SHA2_native sha2(bits);
+        sha2.update(in_data[i], lens[i]);
+        sha2.finalize();
+        std::string digest = sha2.getRawDigest();
+        std::memcpy(out_data[i], digest.data(), digest.size());
+    }
+}
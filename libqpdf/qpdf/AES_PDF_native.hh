@@ -19,13 +19,26 @@ class AES_PDF_native
 
     void update(unsigned char* in_data, unsigned char* out_data);
 
+    // Process len bytes, which must be a multiple of the block size. in_data and out_data may be
+    // the same. Unlike the single block version, in_data is not modified unless it is the same as
+    // out_data.
+    void update(unsigned char const* in_data, unsigned char* out_data, size_t len);
+
+    // Return whether AES instructions of the CPU are used.
+    static bool hardwareSupport();
+
   private:
+    void encryptBlock(unsigned char const* in_data, unsigned char* out_data);
+    void decryptBlock(unsigned char const* in_data, unsigned char* out_data);
+
     bool encrypt;
     bool cbc_mode;
     unsigned char* cbc_block;
     std::unique_ptr<unsigned char[]> key;
     std::unique_ptr<uint32_t[]> rk;
     unsigned int nrounds;
+    // The round keys as bytes in the order used by the AES instructions, if they are used.
+    std::unique_ptr<unsigned char[]> round_keys;
 };
 
 #endif // AES_PDF_NATIVE_HH
@@ -0,0 +1,390 @@
+#ifndef CHARSCAN_HH
+#define CHARSCAN_HH
+
+#include <qpdf/Util.hh>
+
+#include <cstddef>
+#include <string_view>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+# define QPDF_CHARSCAN_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define QPDF_CHARSCAN_SSE2
+#endif
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
+namespace qpdf::scan
+{
+    // Functions to find the end of a run of characters of some class in a buffer, such as the end
+    // of a run of white space or of a name token. Each function returns the position of the first
+    // character at or after pos that does not belong to the run, or data.size() if there is none.
+    //
+    // The character classes are the ones used by the tokenizer and the JSON parser. Whole blocks of
+    // 16 (SSE2) or 32 (AVX2) bytes are classified at a time where the compiler targets those
+    // instruction sets. Otherwise, and for the tail of the buffer, characters are classified one at
+    // a time. AVX2 is only used if the compiler has been told to target it, e.g. with -mavx2 or
+    // -march=native. The runs these functions are used for are usually short, so a run time check
+    // for AVX2 would cost more than it could save.
+
+    namespace detail
+    {
+        inline unsigned
+        first_bit(unsigned mask)
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long idx;
+            _BitScanForward(&idx, mask);
+            return static_cast<unsigned>(idx);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        // PDF white space, including NUL, which the tokenizer treats as white space.
+        struct Space
+        {
+            static bool
+            match(char ch)
+            {
+                return ch == '\0' || util::is_space(ch);
+            }
+        };
+
+        struct NonSpace
+        {
+            static bool
+            match(char ch)
+            {
+                return !Space::match(ch);
+            }
+        };
+
+        // The characters that terminate names, numbers and other words.
+        struct Delimiter
+        {
+            static bool
+            match(char ch)
+            {
+                return Space::match(ch) || ch == '/' || ch == '(' || ch == ')' || ch == '{' ||
+                    ch == '}' || ch == '<' || ch == '>' || ch == '[' || ch == ']' || ch == '%';
+            }
+        };
+
+        struct NameSpecial
+        {
+            static bool
+            match(char ch)
+            {
+                return ch == '#' || Delimiter::match(ch);
+            }
+        };
+
+        struct NonDigit
+        {
+            static bool
+            match(char ch)
+            {
+                return !util::is_digit(ch);
+            }
+        };
+
+        // Characters that need special handling inside a literal string.
+        struct StringSpecial
+        {
+            static bool
+            match(char ch)
+            {
+                return ch == '(' || ch == ')' || ch == '\\' || ch == '\r';
+            }
+        };
+
+        struct EOL
+        {
+            static bool
+            match(char ch)
+            {
+                return ch == '\r' || ch == '\n';
+            }
+        };
+
+        // JSON white space.
+        struct JSONNonSpace
+        {
+            static bool
+            match(char ch)
+            {
+                return !(ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t');
+            }
+        };
+
+        // Characters that end a run of ordinary characters in a JSON string: the closing quote,
+        // a backslash, or a control character.
+        struct JSONStringSpecial
+        {
+            static bool
+            match(char ch)
+            {
+                return ch == '"' || ch == '\\' || static_cast<unsigned char>(ch) < 0x20;
+            }
+        };
+
+#ifdef QPDF_CHARSCAN_SSE2
+        inline __m128i
+        eq(__m128i v, char ch)
+        {
+            return _mm_cmpeq_epi8(v, _mm_set1_epi8(ch));
+        }
+
+        // Bytes in [lo, hi], compared as unsigned.
+        inline __m128i
+        in_range(__m128i v, char lo, char hi)
+        {
+            auto const width = _mm_set1_epi8(static_cast<char>(hi - lo));
+            auto const d = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+            return _mm_cmpeq_epi8(_mm_max_epu8(d, width), width);
+        }
+
+        inline __m128i
+        match(Space, __m128i v)
+        {
+            return _mm_or_si128(_mm_or_si128(eq(v, '\0'), eq(v, ' ')), in_range(v, '\t', '\r'));
+        }
+
+        inline __m128i
+        match(NonSpace, __m128i v)
+        {
+            return _mm_xor_si128(match(Space(), v), _mm_set1_epi8(-1));
+        }
+
+        inline __m128i
+        match(Delimiter, __m128i v)
+        {
+            auto m = _mm_or_si128(match(Space(), v), eq(v, '/'));
+            m = _mm_or_si128(m, _mm_or_si128(eq(v, '('), eq(v, ')')));
+            m = _mm_or_si128(m, _mm_or_si128(eq(v, '{'), eq(v, '}')));
+            m = _mm_or_si128(m, _mm_or_si128(eq(v, '<'), eq(v, '>')));
+            m = _mm_or_si128(m, _mm_or_si128(eq(v, '['), eq(v, ']')));
+            return _mm_or_si128(m, eq(v, '%'));
+        }
+
+        inline __m128i
+        match(NameSpecial, __m128i v)
+        {
+            return _mm_or_si128(match(Delimiter(), v), eq(v, '#'));
+        }
+
+        inline __m128i
+        match(NonDigit, __m128i v)
+        {
+            return _mm_xor_si128(in_range(v, '0', '9'), _mm_set1_epi8(-1));
+        }
+
+        inline __m128i
+        match(StringSpecial, __m128i v)
+        {
+            return _mm_or_si128(
+                _mm_or_si128(eq(v, '('), eq(v, ')')), _mm_or_si128(eq(v, '\\'), eq(v, '\r')));
+        }
+
+        inline __m128i
+        match(EOL, __m128i v)
+        {
+            return _mm_or_si128(eq(v, '\r'), eq(v, '\n'));
+        }
+
+        inline __m128i
+        match(JSONNonSpace, __m128i v)
+        {
+            auto m = _mm_or_si128(
+                _mm_or_si128(eq(v, ' '), eq(v, '\n')), _mm_or_si128(eq(v, '\r'), eq(v, '\t')));
+            return _mm_xor_si128(m, _mm_set1_epi8(-1));
+        }
+
+        inline __m128i
+        match(JSONStringSpecial, __m128i v)
+        {
+            return _mm_or_si128(
+                _mm_or_si128(eq(v, '"'), eq(v, '\\')), in_range(v, '\0', '\x1f'));
+        }
+#endif // QPDF_CHARSCAN_SSE2
+
+#ifdef QPDF_CHARSCAN_AVX2
+        inline __m256i
+        eq(__m256i v, char ch)
+        {
+            return _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ch));
+        }
+
+        inline __m256i
+        in_range(__m256i v, char lo, char hi)
+        {
+            auto const width = _mm256_set1_epi8(static_cast<char>(hi - lo));
+            auto const d = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+            return _mm256_cmpeq_epi8(_mm256_max_epu8(d, width), width);
+        }
+
+        inline __m256i
+        match(Space, __m256i v)
+        {
+            return _mm256_or_si256(
+                _mm256_or_si256(eq(v, '\0'), eq(v, ' ')), in_range(v, '\t', '\r'));
+        }
+
+        inline __m256i
+        match(NonSpace, __m256i v)
+        {
+            return _mm256_xor_si256(match(Space(), v), _mm256_set1_epi8(-1));
+        }
+
+        inline __m256i
+        match(Delimiter, __m256i v)
+        {
+            auto m = _mm256_or_si256(match(Space(), v), eq(v, '/'));
+            m = _mm256_or_si256(m, _mm256_or_si256(eq(v, '('), eq(v, ')')));
+            m = _mm256_or_si256(m, _mm256_or_si256(eq(v, '{'), eq(v, '}')));
+            m = _mm256_or_si256(m, _mm256_or_si256(eq(v, '<'), eq(v, '>')));
+            m = _mm256_or_si256(m, _mm256_or_si256(eq(v, '['), eq(v, ']')));
+            return _mm256_or_si256(m, eq(v, '%'));
+        }
+
+        inline __m256i
+        match(NameSpecial, __m256i v)
+        {
+            return _mm256_or_si256(match(Delimiter(), v), eq(v, '#'));
+        }
+
+        inline __m256i
+        match(NonDigit, __m256i v)
+        {
+            return _mm256_xor_si256(in_range(v, '0', '9'), _mm256_set1_epi8(-1));
+        }
+
+        inline __m256i
+        match(StringSpecial, __m256i v)
+        {
+            return _mm256_or_si256(
+                _mm256_or_si256(eq(v, '('), eq(v, ')')),
+                _mm256_or_si256(eq(v, '\\'), eq(v, '\r')));
+        }
+
+        inline __m256i
+        match(EOL, __m256i v)
+        {
+            return _mm256_or_si256(eq(v, '\r'), eq(v, '\n'));
+        }
+
+        inline __m256i
+        match(JSONNonSpace, __m256i v)
+        {
+            auto m = _mm256_or_si256(
+                _mm256_or_si256(eq(v, ' '), eq(v, '\n')),
+                _mm256_or_si256(eq(v, '\r'), eq(v, '\t')));
+            return _mm256_xor_si256(m, _mm256_set1_epi8(-1));
+        }
+
+        inline __m256i
+        match(JSONStringSpecial, __m256i v)
+        {
+            return _mm256_or_si256(
+                _mm256_or_si256(eq(v, '"'), eq(v, '\\')), in_range(v, '\0', '\x1f'));
+        }
+#endif // QPDF_CHARSCAN_AVX2
+
+        // Return the position of the first character at or after pos for which Class::match is
+        // true, or data.size().
+        template <class Class>
+        inline size_t
+        find(std::string_view data, size_t pos)
+        {
+            auto const size = data.size();
+            auto const* const p = data.data();
+#ifdef QPDF_CHARSCAN_AVX2
+            for (; pos + 32 <= size; pos += 32) {
+                auto v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + pos));
+                if (auto mask = static_cast<unsigned>(_mm256_movemask_epi8(match(Class(), v)))) {
+                    return pos + first_bit(mask);
+                }
+            }
+#endif
+#ifdef QPDF_CHARSCAN_SSE2
+            for (; pos + 16 <= size; pos += 16) {
+                auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + pos));
+                if (auto mask = static_cast<unsigned>(_mm_movemask_epi8(match(Class(), v)))) {
+                    return pos + first_bit(mask);
+                }
+            }
+#endif
+            for (; pos < size; ++pos) {
+                if (Class::match(p[pos])) {
+                    return pos;
+                }
+            }
+            return size;
+        }
+
+    } // namespace detail
+
+    // End of a run of white space.
+    inline size_t
+    skip_space(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::NonSpace>(data, pos);
+    }
+
+    // End of a word, number or name without '#' escapes: the first delimiter.
+    inline size_t
+    find_delimiter(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::Delimiter>(data, pos);
+    }
+
+    // End of the part of a name before the next '#' escape or delimiter.
+    inline size_t
+    find_name_special(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::NameSpecial>(data, pos);
+    }
+
+    // End of a run of decimal digits.
+    inline size_t
+    skip_digits(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::NonDigit>(data, pos);
+    }
+
+    // Next '(', ')', '\\' or '\r' in a literal string.
+    inline size_t
+    find_string_special(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::StringSpecial>(data, pos);
+    }
+
+    // Next '\r' or '\n'.
+    inline size_t
+    find_eol(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::EOL>(data, pos);
+    }
+
+    // End of a run of JSON white space.
+    inline size_t
+    skip_json_space(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::JSONNonSpace>(data, pos);
+    }
+
+    // Next '"', '\\' or control character in a JSON string.
+    inline size_t
+    find_json_string_special(std::string_view data, size_t pos)
+    {
+        return detail::find<detail::JSONStringSpecial>(data, pos);
+    }
+
+} // namespace qpdf::scan
+
+#endif // CHARSCAN_HH
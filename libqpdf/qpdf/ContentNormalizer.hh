@@ -3,12 +3,12 @@
 
 #include <qpdf/QPDFObjectHandle.hh>
 
-class ContentNormalizer: public QPDFObjectHandle::TokenFilter
+class ContentNormalizer: public QPDFObjectHandle::TokenViewFilter
 {
   public:
     ContentNormalizer();
     ~ContentNormalizer() override = default;
-    void handleToken(QPDFTokenizer::Token const&) override;
+    void handleToken(QPDFTokenizer::TokenView const&) override;
 
     bool anyBadTokens() const;
     bool lastTokenWasBad() const;
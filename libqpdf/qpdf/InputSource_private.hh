@@ -3,13 +3,32 @@
 
 #include <qpdf/BufferInputSource.hh>
 #include <qpdf/InputSource.hh>
+#include <qpdf/MmapInputSource.hh>
 
 #include <limits>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <typeinfo>
 
 namespace qpdf::is
 {
+    // If the entire contents of input are available as contiguous memory, as they are for an
+    // MmapInputSource or a BufferInputSource, return them so that callers can work on them
+    // directly rather than copying through read(). Otherwise, return an empty view.
+    inline std::string_view
+    view(InputSource& input)
+    {
+        if (typeid(input) == typeid(MmapInputSource)) {
+            return static_cast<MmapInputSource&>(input).view();
+        }
+        if (typeid(input) == typeid(BufferInputSource)) {
+            return static_cast<BufferInputSource&>(input).view();
+        }
+        return {};
+    }
+
     class OffsetBuffer final: public InputSource
     {
       public:
@@ -73,11 +92,105 @@ namespace qpdf::is
             proxied.unreadCh(ch);
         }
 
+        std::string_view
+        view() const
+        {
+            return proxied.view();
+        }
+
+        qpdf_offset_t
+        globalOffset() const
+        {
+            return global_offset;
+        }
+
       private:
         BufferInputSource proxied;
         qpdf_offset_t global_offset;
     };
 
+    // As view, but also accept an OffsetBuffer. Set offset to the offset within input of the start
+    // of the returned view.
+    inline std::string_view
+    view(InputSource& input, qpdf_offset_t& offset)
+    {
+        if (typeid(input) == typeid(OffsetBuffer)) {
+            auto& ob = static_cast<OffsetBuffer&>(input);
+            offset = ob.globalOffset();
+            return ob.view();
+        }
+        offset = 0;
+        return view(input);
+    }
+
+    // An input source that reads another input source a block at a time and keeps track of its
+    // position itself, so that small reads, seeks, and calls to tell are served from memory rather
+    // than each going to the underlying source. This is used for files opened by QPDF::processFile,
+    // for which each of those operations would otherwise be a stdio call. The tokenizer works
+    // directly on the contents of the buffer using window().
+    class Buffered final: public InputSource
+    {
+      public:
+        static constexpr size_t block_size = 65536;
+
+        Buffered(std::shared_ptr<InputSource> source) :
+            source(std::move(source))
+        {
+        }
+
+        ~Buffered() final = default;
+
+        qpdf_offset_t findAndSkipNextEOL() final;
+
+        std::string const&
+        getName() const final
+        {
+            return source->getName();
+        }
+
+        qpdf_offset_t
+        tell() final
+        {
+            return pos;
+        }
+
+        void seek(qpdf_offset_t offset, int whence) final;
+
+        void
+        rewind() final
+        {
+            pos = 0;
+        }
+
+        size_t read(char* buffer, size_t length) final;
+
+        void
+        unreadCh(char) final
+        {
+            if (pos > 0) {
+                --pos;
+            }
+        }
+
+        // Return the contents of the input starting at offset up to the end of the block containing
+        // it, loading the block if necessary. Return an empty view at EOF.
+        std::string_view window(qpdf_offset_t offset);
+
+      private:
+        std::shared_ptr<InputSource> source;
+        std::unique_ptr<char[]> block;
+        size_t block_len{0};
+        qpdf_offset_t block_start{0};
+        qpdf_offset_t pos{0};
+    };
+
+    // If input is a Buffered, return it.
+    inline Buffered*
+    buffered(InputSource& input)
+    {
+        return typeid(input) == typeid(Buffered) ? static_cast<Buffered*>(&input) : nullptr;
+    }
+
 } // namespace qpdf::is
 
 inline size_t
@@ -125,31 +238,25 @@ InputSource::fastTell()
     return last_offset;
 }
 
-inline bool
-InputSource::fastRead(char& ch)
+inline std::string_view
+InputSource::fastWindow()
 {
-    // Before calling fastRead, fastTell must be called to prepare the buffer. Once reading is
-    // complete, fastUnread must be called to set the correct file position.
-    if (buf_idx < buf_len) {
-        ch = buffer[buf_idx];
-        ++(buf_idx);
-        ++(last_offset);
-        return true;
-
-    } else if (buf_len == 0) {
-        return false;
-    } else {
+    // Return the unread part of the buffer, loading the next block of the input if all of it has
+    // been consumed. An empty result means EOF. Before calling fastWindow, fastTell must be called
+    // to prepare the buffer. Callers report how much of the window they have consumed with
+    // fastAdvance and, once reading is complete, seek to their final position.
+    if (buf_idx == buf_len && buf_len > 0) {
         seek(buf_start + buf_len, SEEK_SET);
         fastTell();
-        return fastRead(ch);
     }
+    return {buffer + buf_idx, static_cast<size_t>(buf_len - buf_idx)};
 }
 
 inline void
-InputSource::fastUnread(bool back)
+InputSource::fastAdvance(size_t n)
 {
-    last_offset -= back ? 1 : 0;
-    seek(last_offset, SEEK_SET);
+    buf_idx += static_cast<qpdf_offset_t>(n);
+    last_offset += static_cast<qpdf_offset_t>(n);
 }
 
 #endif // QPDF_INPUTSOURCE_PRIVATE_HH
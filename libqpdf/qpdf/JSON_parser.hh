@@ -0,0 +1,137 @@
+#ifndef JSON_PARSER_HH
+#define JSON_PARSER_HH
+
+#include <qpdf/InputSource.hh>
+#include <qpdf/Types.h>
+
+#include <string_view>
+
+// An event-driven interface to the JSON parser for code within the library that processes large
+// JSON inputs. It reports the same events as JSON::Reactor and detects the same errors, but no JSON
+// objects are created. Values are passed as views of the parser's buffers and are only valid until
+// the handler method they are passed to returns.
+namespace qpdf::json
+{
+    class Value
+    {
+      public:
+        enum type_e { t_null, t_bool, t_number, t_string, t_dictionary, t_array };
+
+        Value(type_e type, std::string_view text, qpdf_offset_t start, qpdf_offset_t end) :
+            type(type),
+            text(text),
+            start(start),
+            end(end)
+        {
+        }
+
+        type_e
+        getType() const
+        {
+            return type;
+        }
+
+        bool
+        isDictionary() const
+        {
+            return type == t_dictionary;
+        }
+
+        bool
+        isArray() const
+        {
+            return type == t_array;
+        }
+
+        bool
+        isNull() const
+        {
+            return type == t_null;
+        }
+
+        bool
+        getBool(bool& value) const
+        {
+            if (type != t_bool) {
+                return false;
+            }
+            value = text == "true";
+            return true;
+        }
+
+        // The number exactly as it appears in the input.
+        bool
+        getNumber(std::string_view& value) const
+        {
+            if (type != t_number) {
+                return false;
+            }
+            value = text;
+            return true;
+        }
+
+        // The string with escape sequences replaced.
+        bool
+        getString(std::string_view& value) const
+        {
+            if (type != t_string) {
+                return false;
+            }
+            value = text;
+            return true;
+        }
+
+        // The offsets of the first character of the value and of the character after it. For a
+        // container passed to Handler::dictionaryItem or Handler::arrayItem, the end is after its
+        // opening delimiter. For one passed to Handler::containerEnd, it is after its closing
+        // delimiter.
+        qpdf_offset_t
+        getStart() const
+        {
+            return start;
+        }
+
+        qpdf_offset_t
+        getEnd() const
+        {
+            return end;
+        }
+
+      private:
+        type_e type;
+        std::string_view text;
+        qpdf_offset_t start;
+        qpdf_offset_t end;
+    };
+
+    // The methods are called in the same order as those of JSON::Reactor. Nested containers are
+    // passed to dictionaryItem or arrayItem before dictionaryStart or arrayStart is called for
+    // them.
+    class Handler
+    {
+      public:
+        virtual ~Handler() = default;
+        virtual void dictionaryStart() = 0;
+        virtual void arrayStart() = 0;
+        virtual void containerEnd(Value const& value) = 0;
+        virtual void topLevelScalar() = 0;
+        virtual void dictionaryItem(std::string_view key, Value const& value) = 0;
+        virtual void arrayItem(Value const& value) = 0;
+
+        // Called before reading a string that is the value of the dictionary item with the given
+        // key. If it returns true, the characters of the string are checked but not collected, and
+        // the value passed to dictionaryItem has no text, only offsets. This is for large strings
+        // that the handler reads from the input later, if at all.
+        virtual bool
+        skipStringValue(std::string_view)
+        {
+            return false;
+        }
+    };
+
+    // Parse the JSON in is, passing everything found to handler. Errors are thrown as
+    // std::runtime_error with the same messages as those thrown by JSON::parse.
+    void parse(InputSource& is, Handler& handler);
+} // namespace qpdf::json
+
+#endif // JSON_PARSER_HH
@@ -6,6 +6,7 @@
 #include <qpdf/Pl_Base64.hh>
 #include <qpdf/Pl_Concatenate.hh>
 
+#include <functional>
 #include <string_view>
 
 // Writer is a small utility class to aid writing JSON to a pipeline. Methods are designed to allow
@@ -39,6 +40,18 @@ class JSON::Writer
         return *this;
     }
 
+    // Write the base64 encoding of the data that fn writes to the pipeline it is given. The
+    // pipeline may be finished by fn.
+    Writer&
+    writeBase64(std::function<void(Pipeline&)> const& fn)
+    {
+        Pl_Concatenate cat{"writer concat", p};
+        Pl_Base64 base{"writer base64", &cat, Pl_Base64::a_encode};
+        fn(base);
+        base.finish();
+        return *this;
+    }
+
     Writer&
     writeNext()
     {
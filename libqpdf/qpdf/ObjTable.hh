@@ -6,6 +6,10 @@
 
 #include "qpdf/QIntC.hh"
 #include <limits>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
 // A table of objects indexed by object id. This is intended as a more efficient replacement for
 // std::map<QPDFObjGen, T> containers.
@@ -199,4 +203,353 @@ class ObjTable: public std::vector<T>
     }
 };
 
+// A table of values keyed by QPDFObjGen. This is intended as a more efficient replacement for
+// std::map<QPDFObjGen, T> containers that may contain more than one generation of an object id and
+// whose size is not known in advance, such as the xref table and object cache of QPDF.
+//
+// Values are held in fixed-size chunks of slots indexed by object id, with each slot recording the
+// generation it holds. Chunks are allocated on demand and never move, so, as with std::map,
+// references to values are only invalidated by erasing them. The range of ids covered by chunks
+// only grows while that keeps the table at least roughly half full. Ids beyond it and additional
+// generations of ids whose slot is already taken are kept in the map 'sparse_elements'.
+//
+// The interface mirrors the subset of std::map used by QPDF. Iteration is in QPDFObjGen order.
+// Iterators are not invalidated by adding or erasing other elements.
+template <class T>
+class ObjGenTable
+{
+    struct Slot
+    {
+        // A negative generation marks an empty slot.
+        int gen{-1};
+        T value{};
+    };
+
+    static constexpr size_t chunk_bits = 10;
+    static constexpr size_t chunk_size = size_t(1) << chunk_bits;
+
+    template <class Table, class V>
+    class Iterator
+    {
+        friend class ObjGenTable;
+
+        using sparse_iterator = decltype(std::declval<Table&>().sparse_elements.begin());
+
+      public:
+        using value_type = std::pair<QPDFObjGen const, V&>;
+
+        Iterator(Table& table, size_t idx, sparse_iterator sparse) :
+            table(&table),
+            idx(idx),
+            sparse(sparse)
+        {
+            settle();
+        }
+
+        value_type
+        operator*() const
+        {
+            if (dense) {
+                auto& slot = *table->slot(idx);
+                return {QPDFObjGen(static_cast<int>(idx), slot.gen), slot.value};
+            }
+            return {sparse->first, sparse->second};
+        }
+
+        struct Arrow
+        {
+            value_type value;
+
+            value_type const*
+            operator->() const
+            {
+                return &value;
+            }
+        };
+
+        Arrow
+        operator->() const
+        {
+            return {**this};
+        }
+
+        Iterator&
+        operator++()
+        {
+            if (dense) {
+                ++idx;
+            } else {
+                ++sparse;
+            }
+            settle();
+            return *this;
+        }
+
+        bool
+        operator==(Iterator const& other) const
+        {
+            return (at_end() && other.at_end()) || (idx == other.idx && sparse == other.sparse);
+        }
+
+        bool
+        operator!=(Iterator const& other) const
+        {
+            return !(*this == other);
+        }
+
+      private:
+        Table* table;
+        size_t idx;
+        sparse_iterator sparse;
+        bool dense{false};
+
+        bool
+        at_end() const
+        {
+            return idx >= table->dense_end && sparse == table->sparse_elements.end();
+        }
+
+        // Position on the smaller of the next occupied slot and the next sparse element.
+        void
+        settle()
+        {
+            auto end = table->dense_end;
+            while (idx < end) {
+                if (!table->chunks[idx >> chunk_bits]) {
+                    idx = ((idx >> chunk_bits) + 1) << chunk_bits;
+                } else if (table->slot(idx)->gen < 0) {
+                    ++idx;
+                } else {
+                    break;
+                }
+            }
+            dense = idx < end &&
+                (sparse == table->sparse_elements.end() ||
+                 QPDFObjGen(static_cast<int>(idx), table->slot(idx)->gen) < sparse->first);
+        }
+    };
+
+  public:
+    using iterator = Iterator<ObjGenTable, T>;
+    using const_iterator = Iterator<ObjGenTable const, T const>;
+
+    ObjGenTable() = default;
+    ObjGenTable(ObjGenTable const&) = delete;
+    ObjGenTable& operator=(ObjGenTable const&) = delete;
+
+    iterator
+    begin()
+    {
+        return {*this, 0, sparse_elements.begin()};
+    }
+
+    iterator
+    end()
+    {
+        return {*this, dense_end, sparse_elements.end()};
+    }
+
+    const_iterator
+    begin() const
+    {
+        return {*this, 0, sparse_elements.begin()};
+    }
+
+    const_iterator
+    end() const
+    {
+        return {*this, dense_end, sparse_elements.end()};
+    }
+
+    const_iterator
+    cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator
+    cend() const
+    {
+        return end();
+    }
+
+    size_t
+    size() const
+    {
+        return n_elements;
+    }
+
+    bool
+    empty() const
+    {
+        return n_elements == 0;
+    }
+
+    void
+    clear()
+    {
+        chunks.clear();
+        sparse_elements.clear();
+        n_elements = 0;
+        dense_end = 0;
+    }
+
+    // Cover ids less than n_ids with slots. This is for callers that know in advance which ids they
+    // are about to add, and is only worthwhile if most of them will be used.
+    void
+    reserve_ids(size_t n_ids)
+    {
+        auto n_chunks = (n_ids + chunk_size - 1) >> chunk_bits;
+        if (n_chunks > chunks.size()) {
+            chunks.resize(n_chunks);
+        }
+    }
+
+    // Return a pointer to the value for og, or nullptr if there is none.
+    T*
+    get(QPDFObjGen og)
+    {
+        return const_cast<T*>(std::as_const(*this).get(og));
+    }
+
+    T const*
+    get(QPDFObjGen og) const
+    {
+        auto id = og.getObj();
+        if (id >= 0) {
+            auto s = slot(static_cast<size_t>(id));
+            if (s && s->gen == og.getGen() && s->gen >= 0) {
+                return &s->value;
+            }
+        }
+        if (sparse_elements.empty()) {
+            return nullptr;
+        }
+        auto it = sparse_elements.find(og);
+        return it == sparse_elements.end() ? nullptr : &it->second;
+    }
+
+    size_t
+    count(QPDFObjGen og) const
+    {
+        return get(og) ? 1 : 0;
+    }
+
+    // Return the value for og, inserting a default-constructed value if there is none.
+    T&
+    operator[](QPDFObjGen og)
+    {
+        return try_emplace(og).first;
+    }
+
+    // If there is no value for og, construct one from args. Return the value for og and whether it
+    // was inserted.
+    template <class... Args>
+    std::pair<T&, bool>
+    try_emplace(QPDFObjGen og, Args&&... args)
+    {
+        if (auto value = get(og)) {
+            return {*value, false};
+        }
+        ++n_elements;
+        auto id = og.getObj();
+        if (id >= 0 && og.getGen() >= 0) {
+            auto idx = static_cast<size_t>(id);
+            auto chunk = idx >> chunk_bits;
+            if (chunk >= chunks.size() && idx < 2 * n_elements + chunk_size) {
+                chunks.resize(std::max(chunk + 1, 2 * chunks.size()));
+            }
+            if (chunk < chunks.size()) {
+                if (!chunks[chunk]) {
+                    chunks[chunk] = std::make_unique<Slot[]>(chunk_size);
+                }
+                auto& s = chunks[chunk][idx & (chunk_size - 1)];
+                if (s.gen < 0) {
+                    s.gen = og.getGen();
+                    s.value = T(std::forward<Args>(args)...);
+                    dense_end = std::max(dense_end, idx + 1);
+                    return {s.value, true};
+                }
+            }
+        }
+        return {sparse_elements.try_emplace(og, std::forward<Args>(args)...).first->second, true};
+    }
+
+    void
+    erase(QPDFObjGen og)
+    {
+        auto id = og.getObj();
+        if (id >= 0 && og.getGen() >= 0) {
+            auto idx = static_cast<size_t>(id);
+            if (auto s = slot(idx); s && s->gen == og.getGen()) {
+                *s = Slot();
+                --n_elements;
+                while (dense_end > 0 && !occupied(dense_end - 1)) {
+                    --dense_end;
+                }
+                return;
+            }
+        }
+        if (sparse_elements.erase(og)) {
+            --n_elements;
+        }
+    }
+
+    // Return the largest key in the table, or 0/0 if the table is empty.
+    QPDFObjGen
+    last() const
+    {
+        QPDFObjGen result;
+        if (!sparse_elements.empty()) {
+            result = sparse_elements.rbegin()->first;
+        }
+        if (dense_end > 0) {
+            auto og = QPDFObjGen(static_cast<int>(dense_end - 1), slot(dense_end - 1)->gen);
+            return result < og ? og : result;
+        }
+        return result;
+    }
+
+    // Return whether the table contains a larger generation of og's object id.
+    bool
+    has_later_generation(QPDFObjGen og) const
+    {
+        if (og.getObj() >= 0) {
+            auto s = slot(static_cast<size_t>(og.getObj()));
+            if (s && s->gen > og.getGen()) {
+                return true;
+            }
+        }
+        if (sparse_elements.empty()) {
+            return false;
+        }
+        auto it = sparse_elements.upper_bound(og);
+        return it != sparse_elements.end() && it->first.getObj() == og.getObj();
+    }
+
+  private:
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    std::map<QPDFObjGen, T> sparse_elements;
+    size_t n_elements{0};
+    // One more than the largest id of an occupied slot.
+    size_t dense_end{0};
+
+    Slot*
+    slot(size_t idx) const
+    {
+        auto chunk = idx >> chunk_bits;
+        if (chunk < chunks.size() && chunks[chunk]) {
+            return &chunks[chunk][idx & (chunk_size - 1)];
+        }
+        return nullptr;
+    }
+
+    bool
+    occupied(size_t idx) const
+    {
+        auto s = slot(idx);
+        return s && s->gen >= 0;
+    }
+};
+
 #endif // OBJTABLE_HH
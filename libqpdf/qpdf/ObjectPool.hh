@@ -0,0 +1,169 @@
+#ifndef OBJECTPOOL_HH
+#define OBJECTPOOL_HH
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace qpdf
+{
+    // A pool of memory for the objects a QPDF creates while reading its input. Objects are created
+    // with std::allocate_shared and an ObjectPool::Allocator, so each object and its shared_ptr
+    // control block share one allocation. As all objects are QPDFObjects, these allocations are
+    // all the same size, and the pool hands out fixed-size blocks carved from large chunks. Freed
+    // blocks are kept on a free list for reuse.
+    //
+    // Every Allocator holds a reference to its pool, and a copy of the Allocator is kept in the
+    // control block of each object created with it. The pool, and all its chunks, are therefore
+    // released in one go once the QPDF and all objects allocated from the pool are gone, however
+    // long the application holds on to individual objects.
+    //
+    // The pool is not thread-safe. Like the rest of qpdf, it relies on the objects belonging to a
+    // QPDF not being used by more than one thread at a time.
+    class ObjectPool
+    {
+      public:
+        template <class T>
+        class Allocator
+        {
+          public:
+            using value_type = T;
+
+            // Create an allocator with a new pool.
+            Allocator() :
+                pool(new ObjectPool)
+            {
+            }
+
+            Allocator(Allocator const& other) noexcept :
+                pool(other.pool)
+            {
+                ++pool->refs;
+            }
+
+            template <class U>
+            Allocator(Allocator<U> const& other) noexcept :
+                pool(other.pool)
+            {
+                ++pool->refs;
+            }
+
+            Allocator&
+            operator=(Allocator const& other) noexcept
+            {
+                Allocator tmp(other);
+                std::swap(pool, tmp.pool);
+                return *this;
+            }
+
+            ~Allocator()
+            {
+                pool->release();
+            }
+
+            T*
+            allocate(size_t n)
+            {
+                return static_cast<T*>(pool->allocate(n * sizeof(T), alignof(T)));
+            }
+
+            void
+            deallocate(T* p, size_t n) noexcept
+            {
+                pool->deallocate(p, n * sizeof(T), alignof(T));
+            }
+
+            template <class U>
+            bool
+            operator==(Allocator<U> const& other) const noexcept
+            {
+                return pool == other.pool;
+            }
+
+            template <class U>
+            bool
+            operator!=(Allocator<U> const& other) const noexcept
+            {
+                return pool != other.pool;
+            }
+
+          private:
+            template <class U>
+            friend class Allocator;
+
+            ObjectPool* pool;
+        };
+
+        ObjectPool(ObjectPool const&) = delete;
+        ObjectPool& operator=(ObjectPool const&) = delete;
+
+      private:
+        static constexpr size_t alignment = alignof(std::max_align_t);
+        // Chunks start small so that the pool costs little for files with few objects, and double
+        // in size up to 8192 blocks.
+        static constexpr size_t min_chunk_blocks = 64;
+        static constexpr size_t chunk_doublings = 7;
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        ObjectPool() = default;
+        ~ObjectPool() = default;
+
+        void*
+        allocate(size_t size, size_t align)
+        {
+            if (block_size == 0 && size >= sizeof(FreeBlock) && align <= alignment) {
+                // The pool serves the size of its first allocation.
+                block_size = rounded(size);
+            }
+            if (!pooled(size, align)) {
+                return ::operator new(size);
+            }
+            if (!free_list) {
+                add_chunk();
+            }
+            auto block = free_list;
+            free_list = block->next;
+            return block;
+        }
+
+        void
+        deallocate(void* p, size_t size, size_t align) noexcept
+        {
+            if (!pooled(size, align)) {
+                ::operator delete(p);
+                return;
+            }
+            free_list = new (p) FreeBlock{free_list};
+        }
+
+        // Round size up so that consecutive blocks are suitably aligned.
+        static size_t
+        rounded(size_t size)
+        {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+        bool
+        pooled(size_t size, size_t align) const
+        {
+            return block_size && align <= alignment && rounded(size) == block_size;
+        }
+
+        void add_chunk();
+        void release() noexcept;
+
+        // The number of Allocators referring to the pool.
+        size_t refs{1};
+        size_t block_size{0};
+        FreeBlock* free_list{nullptr};
+        std::vector<std::unique_ptr<std::max_align_t[]>> chunks;
+    };
+} // namespace qpdf
+
+#endif // OBJECTPOOL_HH
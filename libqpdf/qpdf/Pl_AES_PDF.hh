@@ -4,6 +4,9 @@
 #include <qpdf/Pipeline.hh>
 #include <qpdf/QPDFCryptoImpl.hh>
 #include <memory>
+#include <string>
+
+class QPDFCryptoBulk;
 
 // This pipeline implements AES-128 and AES-256 with CBC and block padding as specified in the PDF
 // specification.
@@ -38,11 +41,18 @@ class Pl_AES_PDF final: public Pipeline
   private:
     void flush(bool discard_padding);
     void initializeVector();
+    void processBulk(bool at_end);
 
     static unsigned int const buf_size = QPDFCryptoImpl::rijndael_buf_size;
+    static size_t const bulk_size = 65536;
     static bool use_static_iv;
 
     std::shared_ptr<QPDFCryptoImpl> crypto;
+    // If the crypto provider can process many blocks at once, data is collected in bulk_in and
+    // processed bulk_size bytes at a time. Otherwise it is processed a block at a time.
+    QPDFCryptoBulk* bulk{nullptr};
+    std::string bulk_in;
+    std::string bulk_out;
     bool encrypt;
     bool cbc_mode{true};
     bool first{true};
@@ -0,0 +1,65 @@
+#ifndef PL_BOUNDED_HH
+#define PL_BOUNDED_HH
+
+#include <qpdf/Pipeline.hh>
+
+#include <string>
+
+// Keep the data written to the pipeline unless there is more of it than limit, in which case the
+// data is discarded and only the fact that it did not fit is remembered.
+class Pl_Bounded final: public Pipeline
+{
+  public:
+    Pl_Bounded(char const* identifier, size_t limit) :
+        Pipeline(identifier, nullptr),
+        limit(limit)
+    {
+    }
+    ~Pl_Bounded() final = default;
+
+    void
+    write(unsigned char const* buf, size_t len) final
+    {
+        if (overflowed) {
+            return;
+        }
+        if (len > limit - data.size()) {
+            overflowed = true;
+            data.clear();
+            data.shrink_to_fit();
+            return;
+        }
+        data.append(reinterpret_cast<char const*>(buf), len);
+    }
+
+    void
+    finish() final
+    {
+    }
+
+    void
+    reset()
+    {
+        data.clear();
+        overflowed = false;
+    }
+
+    bool
+    fits() const
+    {
+        return !overflowed;
+    }
+
+    std::string const&
+    getString() const
+    {
+        return data;
+    }
+
+  private:
+    size_t limit;
+    std::string data;
+    bool overflowed{false};
+};
+
+#endif // PL_BOUNDED_HH
@@ -0,0 +1,69 @@
+#ifndef PL_CONTENTPARSER_HH
+#define PL_CONTENTPARSER_HH
+
+#include <qpdf/InputSource_private.hh>
+#include <qpdf/Pipeline.hh>
+#include <qpdf/QPDFExc.hh>
+#include <qpdf/QPDFObjectHandle.hh>
+#include <qpdf/QPDFObject_private.hh>
+#include <qpdf/QPDFTokenizer_private.hh>
+
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Parse content stream data as it is written, passing each object and inline image to the
+// callbacks' handleObject method along with its offset and length, exactly as
+// QPDFObjectHandle::parseContentStream does. Only data that has not been parsed yet is kept in
+// memory. An object is not passed on until the data following it shows that it is complete, so
+// objects and inline images may be split across any number of calls to write. The callbacks'
+// contentSize and handleEOF methods are not called.
+//
+// Exceptions thrown while parsing, including by the callbacks, are not allowed to escape from write
+// or finish since the writer may mistake them for errors in the data it is writing. Instead, all
+// further data is discarded, and the exception is rethrown by rethrow().
+class Pl_ContentParser final: public Pipeline
+{
+  public:
+    Pl_ContentParser(
+        char const* identifier,
+        std::string const& description,
+        QPDFObjectHandle::ParserCallbacks* callbacks,
+        QPDF* context,
+        size_t block_size = 65536);
+    ~Pl_ContentParser() final = default;
+    void write(unsigned char const* data, size_t len) final;
+    void finish() final;
+
+    // Rethrow the exception that stopped parsing, if any.
+    void rethrow();
+
+  private:
+    void parse(bool at_end);
+    // Parse the object or inline image starting at done, hand it to the callbacks, and advance
+    // done past it. Return false without doing anything if more data is needed.
+    bool parseObject(
+        qpdf::is::OffsetBuffer& input,
+        qpdf::Tokenizer& tokenizer,
+        qpdf_offset_t& done,
+        bool at_end);
+    bool parseInlineImage(qpdf_offset_t& done, bool at_end);
+
+    std::string description;
+    std::shared_ptr<QPDFObject::Description> sp_description;
+    QPDFObjectHandle::ParserCallbacks* callbacks;
+    QPDF* context;
+    size_t block_size;
+    // Data that has not been parsed yet and the offset of its first byte within the content.
+    std::string pending;
+    qpdf_offset_t pending_offset{0};
+    // Parse once this much data is pending.
+    size_t wanted;
+    // The last object was an ID operator, so the next thing to read is the inline image.
+    bool expect_inline_image{false};
+    std::vector<QPDFExc> warnings;
+    std::exception_ptr error;
+};
+
+#endif // PL_CONTENTPARSER_HH
@@ -0,0 +1,42 @@
+#ifndef QPDFCRYPTOBULK_HH
+#define QPDFCRYPTOBULK_HH
+
+#include <cstddef>
+
+// The crypto providers that are built into qpdf implement this interface in addition to
+// QPDFCryptoImpl. QPDFCryptoImpl processes AES data one block at a time, and the cost of each call
+// into the underlying library far exceeds the cost of encrypting a block. It also hashes only one
+// message at a time. Callers that have many blocks or messages at once should check for this
+// interface with dynamic_cast and fall back to QPDFCryptoImpl's methods for providers that don't
+// implement it.
+class QPDFCryptoBulk
+{
+  public:
+    virtual ~QPDFCryptoBulk() = default;
+
+    // Encrypt or decrypt len bytes from in to out with AES in CBC mode without padding. len must
+    // be a multiple of QPDFCryptoImpl::rijndael_buf_size, and iv must point to that many bytes.
+    // in and out may be the same. This uses the rijndael state of the QPDFCryptoImpl, which must
+    // not be in use at the time.
+    virtual void rijndael_cbc(
+        bool encrypt,
+        unsigned char const* key_data,
+        size_t key_len,
+        unsigned char const* iv,
+        unsigned char const* in_data,
+        unsigned char* out_data,
+        size_t len) = 0;
+
+    // Compute the SHA-2 digests of count independent messages using the given number of bits,
+    // which must be 256, 384, or 512. Message i is lens[i] bytes at in_data[i], and its digest of
+    // bits / 8 bytes is written to out_data[i]. Implementations may hash several of the messages
+    // side by side. This doesn't use or change the SHA2 state of the QPDFCryptoImpl.
+    virtual void SHA2_batch(
+        int bits,
+        size_t count,
+        unsigned char const* const* in_data,
+        size_t const* lens,
+        unsigned char* const* out_data) = 0;
+};
+
+#endif // QPDFCRYPTOBULK_HH
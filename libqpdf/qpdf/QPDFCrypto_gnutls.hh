@@ -1,6 +1,7 @@
 #ifndef QPDFCRYPTO_GNUTLS_HH
 #define QPDFCRYPTO_GNUTLS_HH
 
+#include <qpdf/QPDFCryptoBulk.hh>
 #include <qpdf/QPDFCryptoImpl.hh>
 #include <memory>
 
@@ -10,7 +11,7 @@
 // This comment prevents clang-format from putting crypto.h before gnutls.h
 #include <gnutls/crypto.h>
 
-class QPDFCrypto_gnutls: public QPDFCryptoImpl
+class QPDFCrypto_gnutls: public QPDFCryptoImpl, public QPDFCryptoBulk
 {
   public:
     QPDFCrypto_gnutls();
@@ -42,6 +43,22 @@ class QPDFCrypto_gnutls: public QPDFCryptoImpl
     virtual void rijndael_process(unsigned char* in_data, unsigned char* out_data);
     virtual void rijndael_finalize();
 
+    virtual void rijndael_cbc(
+        bool encrypt,
+        unsigned char const* key_data,
+        size_t key_len,
+        unsigned char const* iv,
+        unsigned char const* in_data,
+        unsigned char* out_data,
+        size_t len);
+
+    virtual void SHA2_batch(
+        int bits,
+        size_t count,
+        unsigned char const* const* in_data,
+        size_t const* lens,
+        unsigned char* const* out_data);
+
   private:
     void badBits();
 
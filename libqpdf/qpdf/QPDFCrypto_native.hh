@@ -3,12 +3,13 @@
 
 #include <qpdf/AES_PDF_native.hh>
 #include <qpdf/MD5_native.hh>
+#include <qpdf/QPDFCryptoBulk.hh>
 #include <qpdf/QPDFCryptoImpl.hh>
 #include <qpdf/RC4_native.hh>
 #include <qpdf/SHA2_native.hh>
 #include <memory>
 
-class QPDFCrypto_native: public QPDFCryptoImpl
+class QPDFCrypto_native: public QPDFCryptoImpl, public QPDFCryptoBulk
 {
   public:
     QPDFCrypto_native() = default;
@@ -40,6 +41,22 @@ class QPDFCrypto_native: public QPDFCryptoImpl
     virtual void rijndael_process(unsigned char* in_data, unsigned char* out_data);
     virtual void rijndael_finalize();
 
+    virtual void rijndael_cbc(
+        bool encrypt,
+        unsigned char const* key_data,
+        size_t key_len,
+        unsigned char const* iv,
+        unsigned char const* in_data,
+        unsigned char* out_data,
+        size_t len);
+
+    virtual void SHA2_batch(
+        int bits,
+        size_t count,
+        unsigned char const* const* in_data,
+        size_t const* lens,
+        unsigned char* const* out_data);
+
   private:
     std::shared_ptr<MD5_native> md5;
     std::shared_ptr<RC4_native> rc4;
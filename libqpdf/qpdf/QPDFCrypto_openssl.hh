@@ -1,6 +1,7 @@
 #ifndef QPDFCRYPTO_OPENSSL_HH
 #define QPDFCRYPTO_OPENSSL_HH
 
+#include <qpdf/QPDFCryptoBulk.hh>
 #include <qpdf/QPDFCryptoImpl.hh>
 #include <string>
 #if (defined(__GNUC__) || defined(__clang__))
@@ -22,7 +23,7 @@
 # pragma GCC diagnostic pop
 #endif
 
-class QPDFCrypto_openssl: public QPDFCryptoImpl
+class QPDFCrypto_openssl: public QPDFCryptoImpl, public QPDFCryptoBulk
 {
   public:
     QPDFCrypto_openssl();
@@ -54,6 +55,22 @@ class QPDFCrypto_openssl: public QPDFCryptoImpl
     void rijndael_process(unsigned char* in_data, unsigned char* out_data) override;
     void rijndael_finalize() override;
 
+    void rijndael_cbc(
+        bool encrypt,
+        unsigned char const* key_data,
+        size_t key_len,
+        unsigned char const* iv,
+        unsigned char const* in_data,
+        unsigned char* out_data,
+        size_t len) override;
+
+    void SHA2_batch(
+        int bits,
+        size_t count,
+        unsigned char const* const* in_data,
+        size_t const* lens,
+        unsigned char* const* out_data) override;
+
   private:
     EVP_MD_CTX* const md_ctx;
     EVP_CIPHER_CTX* const cipher_ctx;
@@ -7,6 +7,7 @@
 #include <qpdf/Constants.h>
 #include <qpdf/JSON.hh>
 #include <qpdf/JSON_writer.hh>
+#include <qpdf/ObjectPool.hh>
 #include <qpdf/QPDF.hh>
 #include <qpdf/QPDFObjGen.hh>
 #include <qpdf/Types.h>
@@ -298,6 +299,25 @@ class QPDFObject
             qpdf, og, std::forward<T>(T(std::forward<Args>(args)...)));
     }
 
+    // Create an object using memory from a QPDF's object pool.
+    template <typename T, typename... Args>
+    inline static std::shared_ptr<QPDFObject>
+    create_pooled(qpdf::ObjectPool::Allocator<QPDFObject> const& pool, Args&&... args)
+    {
+        return std::allocate_shared<QPDFObject>(pool, T(std::forward<Args>(args)...));
+    }
+
+    template <typename T, typename... Args>
+    inline static std::shared_ptr<QPDFObject>
+    create_pooled(
+        qpdf::ObjectPool::Allocator<QPDFObject> const& pool,
+        QPDF* qpdf,
+        QPDFObjGen og,
+        Args&&... args)
+    {
+        return std::allocate_shared<QPDFObject>(pool, qpdf, og, T(std::forward<Args>(args)...));
+    }
+
     std::string getStringValue() const;
 
     // Return a unique type code for the resolved object
@@ -318,6 +338,15 @@ class QPDFObject
         object_description = nullptr;
         parsed_offset = -1;
     }
+    // Return an object read from the input to its unresolved state so that it is read again when
+    // needed.
+    void
+    unresolve()
+    {
+        value = QPDF_Unresolved();
+        object_description = nullptr;
+        parsed_offset = -1;
+    }
     void
     move_to(std::shared_ptr<QPDFObject>& o, bool destroy)
     {
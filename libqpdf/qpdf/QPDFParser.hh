@@ -2,12 +2,14 @@
 #define QPDFPARSER_HH
 
 #include <qpdf/InputSource_private.hh>
+#include <qpdf/QPDFExc.hh>
 #include <qpdf/QPDFObjectHandle_private.hh>
 #include <qpdf/QPDFObject_private.hh>
 #include <qpdf/QPDFTokenizer_private.hh>
 
 #include <memory>
 #include <string>
+#include <vector>
 
 class QPDFParser
 {
@@ -15,11 +17,14 @@ class QPDFParser
     static QPDFObjectHandle
     parse(InputSource& input, std::string const& object_description, QPDF* context);
 
+    // If warnings is not null, warnings are appended to it instead of being issued through context
+    // or thrown.
     static QPDFObjectHandle parse_content(
         InputSource& input,
         std::shared_ptr<QPDFObject::Description> sp_description,
         qpdf::Tokenizer& tokenizer,
-        QPDF* context);
+        QPDF* context,
+        std::vector<QPDFExc>* warnings = nullptr);
 
     // For use by deprecated QPDFObjectHandle::parse.
     static QPDFObjectHandle parse(
@@ -69,6 +74,7 @@ class QPDFParser
         tokenizer(tokenizer),
         decrypter(decrypter),
         context(context),
+        pool(QPDF::ParseGuard::objectPool(context)),
         description(std::move(sp_description)),
         parse_pdf(parse_pdf),
         stream_id(stream_id),
@@ -116,15 +122,25 @@ class QPDFParser
     // NB the offset includes any leading whitespace.
     QPDFObjectHandle withDescription(Args&&... args);
     void setDescription(std::shared_ptr<QPDFObject>& obj, qpdf_offset_t parsed_offset);
+    // Create an object, using the context's object pool if there is a context.
+    template <typename T, typename... Args>
+    std::shared_ptr<QPDFObject>
+    create(Args&&... args)
+    {
+        return pool ? QPDFObject::create_pooled<T>(*pool, std::forward<Args>(args)...)
+                    : QPDFObject::create<T>(std::forward<Args>(args)...);
+    }
     InputSource& input;
     std::string const& object_description;
     qpdf::Tokenizer& tokenizer;
     QPDFObjectHandle::StringDecrypter* decrypter;
     QPDF* context;
+    qpdf::ObjectPool::Allocator<QPDFObject> const* pool;
     std::shared_ptr<QPDFObject::Description> description;
     bool parse_pdf{false};
     int stream_id{0};
     int obj_id{0};
+    std::vector<QPDFExc>* warnings{nullptr};
 
     std::vector<StackFrame> stack;
     StackFrame* frame{nullptr};
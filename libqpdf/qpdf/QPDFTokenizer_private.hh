@@ -3,6 +3,8 @@
 
 #include <qpdf/QPDFTokenizer.hh>
 
+#include <string_view>
+
 namespace qpdf
 {
 
@@ -86,6 +88,7 @@ namespace qpdf
         bool isSpace(char);
         bool isDelimiter(char);
         void findEI(InputSource& input);
+        size_t scanRun(std::string_view data, size_t pos);
 
         enum state_e {
             st_top,
@@ -55,6 +55,16 @@ class QPDFWriter::Members
     Members(QPDF& pdf);
     Members(Members const&) = delete;
 
+    // The results of willFilterStream for a stream that has been prepared ahead of being written.
+    struct PreparedStream
+    {
+        std::string data;
+        std::optional<size_t> raw_length;
+        bool filtered{false};
+        bool compress{false};
+        bool is_metadata{false};
+    };
+
     QPDF& pdf;
     QPDFObjGen root_og{-1, 0};
     char const* filename{"unspecified"};
@@ -69,6 +79,8 @@ class QPDFWriter::Members
     qpdf_stream_decode_level_e stream_decode_level{qpdf_dl_generalized};
     bool stream_decode_level_set{false};
     bool recompress_flate{false};
+    size_t compression_jobs{1};
+    std::map<QPDFObjGen, PreparedStream> prepared_streams;
     bool qdf_mode{false};
     bool preserve_unreferenced_objects{false};
     bool newline_before_endstream{false};
@@ -79,6 +91,10 @@ class QPDFWriter::Members
     bool preserve_encryption{true};
     bool linearized{false};
     bool pclm{false};
+    bool streaming{false};
+    // In streaming mode, whether to collect objects into object streams as they are written.
+    bool streaming_object_streams{false};
+    bool incremental{false};
     qpdf_object_stream_e object_stream_mode{qpdf_o_preserve};
     std::string encryption_key;
     bool encrypt_metadata{true};
@@ -3,9 +3,12 @@
 
 #include <qpdf/QPDF.hh>
 
+#include <qpdf/ObjTable.hh>
 #include <qpdf/QPDFObject_private.hh>
 #include <qpdf/QPDFTokenizer_private.hh>
 
+#include <tuple>
+
 // Writer class is restricted to QPDFWriter so that only it can call certain methods.
 class QPDF::Writer
 {
@@ -59,10 +62,36 @@ class QPDF::Writer
         return qpdf.getCompressibleObjSet();
     }
 
-    static std::map<QPDFObjGen, QPDFXRefEntry> const&
-    getXRefTable(QPDF& qpdf)
+    static ObjGenTable<QPDFXRefEntry> const& getXRefTable(QPDF& qpdf);
+
+    // Return the objects that have been resolved.
+    static std::set<QPDFObjGen> getResolvedObjects(QPDF& qpdf);
+
+    // Release the value of an object that has been written in streaming mode. If the object can be
+    // read again from the input, return it to its unresolved state so that it is read again if it
+    // is needed later. Otherwise, leave it alone. The caller is responsible for not releasing
+    // objects that may have been modified.
+    static void releaseObject(QPDF& qpdf, QPDFObjGen og);
+
+    // Like QPDF::fixDanglingReferences, but without leaving every object of the input in memory.
+    // See QPDF::resolveXRefTable.
+    static void fixDanglingReferencesReleasing(QPDF& qpdf);
+
+    // If stream's data is exactly the bytes stored for it in the input file, return its length.
+    // Such data may be written with copyRawStreamData instead of being piped through the stream's
+    // filters.
+    static std::optional<size_t>
+    rawStreamLength(QPDF& qpdf, QPDFObjectHandle& stream)
+    {
+        return qpdf.rawStreamLength(stream);
+    }
+
+    // Copy the data of a stream for which rawStreamLength returned a value to pipeline. Return the
+    // last character copied.
+    static char
+    copyRawStreamData(QPDF& qpdf, QPDFObjectHandle& stream, Pipeline& pipeline)
     {
-        return qpdf.getXRefTableInternal();
+        return qpdf.copyRawStreamData(stream, pipeline);
     }
 
     static size_t
@@ -70,6 +99,25 @@ class QPDF::Writer
     {
         return qpdf.tableSize();
     }
+
+    // Copy the input file to pipeline. Return its last character.
+    static char
+    copyInputFile(QPDF& qpdf, Pipeline& pipeline)
+    {
+        return qpdf.copyInputFile(pipeline);
+    }
+
+    // Return the objects that differ from the input file, including objects that are not in it,
+    // in order. Objects that have never been resolved are not examined.
+    static std::vector<QPDFObjGen>
+    getModifiedObjects(QPDF& qpdf)
+    {
+        return qpdf.getModifiedObjects();
+    }
+
+    // Return the offset of the input file's last cross-reference section, or 0 if it is not known
+    // or the cross-reference data had to be reconstructed.
+    static qpdf_offset_t getStartXRef(QPDF& qpdf, bool& is_stream);
 };
 
 // The Resolver class is restricted to QPDFObject so that only it can resolve indirect
@@ -121,6 +169,8 @@ class QPDF::ParseGuard
         return qpdf->getObjectForParser(id, gen, parse_pdf);
     }
 
+    static inline qpdf::ObjectPool::Allocator<QPDFObject> const* objectPool(QPDF* qpdf);
+
     ~ParseGuard()
     {
         if (qpdf) {
@@ -150,6 +200,23 @@ class QPDF::Pipe
         return qpdf->pipeStreamData(
             og, offset, length, dict, pipeline, suppress_warnings, will_retry);
     }
+
+    // Discard warnings issued while the object exists. This is used when piping stream data again
+    // after the problems with it have already been reported.
+    class QuietWarnings
+    {
+      public:
+        QuietWarnings(QPDF* qpdf);
+        QuietWarnings(QuietWarnings const&) = delete;
+        QuietWarnings& operator=(QuietWarnings const&) = delete;
+        ~QuietWarnings();
+
+      private:
+        QPDF* qpdf;
+        size_t n_warnings;
+        size_t max_warnings;
+        bool suppress_warnings;
+    };
 };
 
 class QPDF::ObjCache
@@ -171,6 +238,16 @@ class QPDF::ObjCache
     qpdf_offset_t end_after_space{0};
 };
 
+// The decoded data of an object stream and the id, offset and size of each object in it.
+class QPDF::DecodedObjectStream
+{
+  public:
+    std::shared_ptr<Buffer> data;
+    std::vector<std::tuple<int, qpdf_offset_t, size_t>> offsets;
+    // False if the header has not been read yet or could not be read without warnings
+    bool header_read{false};
+};
+
 class QPDF::ObjCopier
 {
   public:
@@ -199,8 +276,18 @@ class QPDF::EncryptionParameters
     std::string provided_password;
     std::string user_password;
     std::string encryption_key;
-    std::string cached_object_encryption_key;
-    QPDFObjGen cached_key_og{};
+    // Keys of individual objects for V < 5 are kept in a direct-mapped cache of object_key_slots
+    // entries, each of which holds the key of the last object and key type that mapped to it.
+    struct ObjectKey
+    {
+        QPDFObjGen og;
+        bool use_aes{false};
+        std::string key;
+    };
+    static size_t const object_key_slots = 4096;
+    std::vector<ObjectKey> object_keys;
+    size_t object_key_hits{0};
+    size_t object_key_misses{0};
     bool user_password_matched{false};
     bool owner_password_matched{false};
 };
@@ -460,23 +547,36 @@ class QPDF::Members
     std::string last_object_description;
     std::shared_ptr<QPDFObject::Description> last_ostream_description;
     bool provided_password_is_hex_key{false};
+    std::vector<std::string> password_candidates;
+    size_t password_candidate_jobs{1};
     bool ignore_xref_streams{false};
+    bool mmap_input{false};
+    size_t object_stream_jobs{1};
     bool suppress_warnings{false};
     size_t max_warnings{0};
     bool attempt_recovery{true};
     bool check_mode{false};
     std::shared_ptr<EncryptionParameters> encp;
     std::string pdf_version;
-    std::map<QPDFObjGen, QPDFXRefEntry> xref_table;
+    ObjGenTable<QPDFXRefEntry> xref_table;
     // Various tables are indexed by object id, with potential size id + 1
     int xref_table_max_id{std::numeric_limits<int>::max() - 1};
     qpdf_offset_t xref_table_max_offset{0};
+    // The offset that startxref points to and whether there is a cross-reference stream there. The
+    // offset is 0 if startxref could not be used.
+    qpdf_offset_t startxref{0};
+    bool startxref_is_stream{false};
     std::set<int> deleted_objects;
-    std::map<QPDFObjGen, ObjCache> obj_cache;
+    // Memory for the objects created while reading the input. See ObjectPool.
+    qpdf::ObjectPool::Allocator<QPDFObject> object_pool;
+    ObjGenTable<ObjCache> obj_cache;
     std::set<QPDFObjGen> resolving;
     QPDFObjectHandle trailer;
     std::vector<QPDFObjectHandle> all_pages;
     bool invalid_page_found{false};
+    // Intermediate nodes of the pages tree that getPage and getPageCount have found well-formed.
+    // Only used while all_pages is empty; cleared whenever all_pages is populated.
+    std::set<QPDFObjGen> valid_page_nodes;
     std::map<QPDFObjGen, int> pageobj_to_pages_pos;
     bool pushed_inherited_attributes_to_pages{false};
     bool ever_pushed_inherited_attributes_to_pages{false};
@@ -492,6 +592,11 @@ class QPDF::Members
     bool in_parse{false};
     bool parsed{false};
     std::set<int> resolved_object_streams;
+    // Object streams that decodeObjectStreams may still decode, and the results it has not handed
+    // to resolveObjectsInStream yet
+    std::optional<std::set<int>> object_streams_to_decode;
+    std::map<int, DecodedObjectStream> decoded_object_streams;
+    size_t decoded_object_streams_bytes{0};
 
     // Linearization data
     qpdf_offset_t first_xref_item_offset{0}; // actual value from file
@@ -526,6 +631,69 @@ class QPDF::Members
     std::map<QPDFObjGen, std::set<ObjUser>> object_to_obj_users;
 };
 
+inline ObjGenTable<QPDFXRefEntry> const&
+QPDF::Writer::getXRefTable(QPDF& qpdf)
+{
+    if (!qpdf.m->parsed) {
+        throw std::logic_error("QPDF::getXRefTable called before parsing.");
+    }
+    return qpdf.m->xref_table;
+}
+
+inline std::set<QPDFObjGen>
+QPDF::Writer::getResolvedObjects(QPDF& qpdf)
+{
+    std::set<QPDFObjGen> result;
+    for (auto const& [og, entry]: qpdf.m->obj_cache) {
+        if (!entry.object->isUnresolved()) {
+            result.insert(og);
+        }
+    }
+    return result;
+}
+
+inline void
+QPDF::Writer::releaseObject(QPDF& qpdf, QPDFObjGen og)
+{
+    auto cached = qpdf.m->obj_cache.get(og);
+    auto entry = qpdf.m->xref_table.get(og);
+    if (!(cached && entry) || cached->object->isUnresolved()) {
+        return;
+    }
+    if (entry->getType() == 1) {
+        cached->object->unresolve();
+    } else if (entry->getType() == 2) {
+        // Reading any object of the object stream again reads all of its unresolved objects.
+        cached->object->unresolve();
+        qpdf.m->resolved_object_streams.erase(entry->getObjStreamNumber());
+    }
+}
+
+inline void
+QPDF::Writer::fixDanglingReferencesReleasing(QPDF& qpdf)
+{
+    if (qpdf.m->fixed_dangling_refs) {
+        return;
+    }
+    if (!qpdf.resolveXRefTable(true)) {
+        qpdf.resolveXRefTable(true);
+    }
+    qpdf.m->fixed_dangling_refs = true;
+}
+
+inline qpdf_offset_t
+QPDF::Writer::getStartXRef(QPDF& qpdf, bool& is_stream)
+{
+    is_stream = qpdf.m->startxref_is_stream;
+    return qpdf.m->reconstructed_xref ? 0 : qpdf.m->startxref;
+}
+
+inline qpdf::ObjectPool::Allocator<QPDFObject> const*
+QPDF::ParseGuard::objectPool(QPDF* qpdf)
+{
+    return qpdf ? &qpdf->m->object_pool : nullptr;
+}
+
 // JobSetter class is restricted to QPDFJob.
 class QPDF::JobSetter
 {
@@ -538,6 +706,14 @@ class QPDF::JobSetter
     {
         qpdf.m->check_mode = val;
     }
+
+    // Return how often keys of individual objects were found in and missing from the cache.
+    static void
+    getObjectKeyCacheStats(QPDF& qpdf, size_t& hits, size_t& misses)
+    {
+        hits = qpdf.m->encp->object_key_hits;
+        misses = qpdf.m->encp->object_key_misses;
+    }
 };
 
 class QPDF::ResolveRecorder
@@ -13,8 +13,17 @@ class SHA2_native
     void finalize();
     std::string getRawDigest();
 
+    // Compute the digests of count messages as described for QPDFCryptoBulk::SHA2_batch. If the
+    // CPU has SHA or AVX2 instructions, several messages are hashed side by side.
+    static void batch(
+        int bits,
+        size_t count,
+        unsigned char const* const* in_data,
+        size_t const* lens,
+        unsigned char* const* out_data);
+
   private:
-    void badBits();
+    static void badBits();
 
     int bits;
     sph_sha256_context ctx256;
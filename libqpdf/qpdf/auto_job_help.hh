@@ -94,6 +94,17 @@ This is used in place of the --password option.
 }
 static void add_help_2(QPDFArgParser& ap)
 {
+ap.addOptionHelp("--password-candidates", "general", "try passwords from a file", R"(--password-candidates=file
+
+Each line of the specified file is a password to try, in
+order, if the password given with --password doesn't work.
+The first one that works is used.
+)");
+ap.addOptionHelp("--password-candidate-jobs", "general", "check password candidates using n threads", R"(--password-candidate-jobs=n
+
+Check the passwords given with --password-candidates using n
+threads. If n is 0, use one thread per available CPU.
+)");
 ap.addOptionHelp("--verbose", "general", "print additional information", R"(Output additional information about various things qpdf is
 doing, including information about files created and operations
 performed.
@@ -148,11 +159,23 @@ cross reference table or stream lengths.
 ap.addOptionHelp("--ignore-xref-streams", "advanced-control", "use xref tables rather than streams", R"(Ignore any cross-reference streams in the file, falling back to
 cross-reference tables or triggering document recovery.
 )");
+ap.addOptionHelp("--mmap-input", "advanced-control", "map the input file into memory", R"(Map the primary input file into memory rather than reading it
+through buffered file I/O. This can speed up processing of
+large files. The file must not change while qpdf is running.
+)");
+ap.addOptionHelp("--object-stream-jobs", "advanced-control", "decode object streams using n threads", R"(--object-stream-jobs=n
+
+Decode the object streams of the input file using n threads. If
+n is 0, use one thread per available CPU.
+)");
 ap.addHelpTopic("transformation", "make structural PDF changes", R"(The options below tell qpdf to apply transformations that change
 the structure without changing the content.
 )");
 ap.addOptionHelp("--linearize", "transformation", "linearize (web-optimize) output", R"(Create linearized (web-optimized) output files.
 )");
+}
+static void add_help_3(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--encrypt", "transformation", "start encryption options", R"(--encrypt [options] --
 
 Run qpdf --help=encryption for details.
@@ -173,9 +196,6 @@ Copy encryption details from the specified file instead of
 preserving the input file's encryption. Use --encryption-file-password
 to specify the encryption file's password.
 )");
-}
-static void add_help_3(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--encryption-file-password", "transformation", "supply password for --copy-encryption", R"(--encryption-file-password=password
 
 If the file named in --copy-encryption requires a password, use
@@ -239,6 +259,24 @@ gzip), which is the default compression for most PDF files.
 You need --recompress-flate with this option if you want to
 change already compressed streams.
 )");
+ap.addOptionHelp("--compression-jobs", "transformation", "compress streams using n threads", R"(--compression-jobs=n
+
+Compress stream data with flate using n threads. If n is 0, use
+one thread per available CPU. The output is identical to that
+written without this option.
+)");
+ap.addOptionHelp("--streaming-write", "transformation", "write output with bounded memory", R"(Release each object's memory as soon as it has been written,
+so memory use while writing doesn't grow with the size of the
+file. Object streams are filled in the order in which objects
+are written. This option may not be used with --linearize.
+)");
+ap.addOptionHelp("--incremental-update", "transformation", "append changes to the input file", R"(Write the output as an incremental update: the input file is
+copied unchanged, and only objects that were changed or added
+are appended, followed by a new cross-reference section. The
+input's encryption is kept. This option may not be used with
+--linearize, --streaming-write, --qdf, --split-pages, or
+options that change encryption.
+)");
 ap.addOptionHelp("--normalize-content", "transformation", "fix newlines in content streams", R"(--normalize-content=[y|n]
 
 Normalize newlines to UNIX-style newlines in PDF content
@@ -261,6 +299,9 @@ Remove from a page's resource dictionary any resources that are
 not referenced in the page's contents. Parameters: "auto"
 (default), "yes", "no".
 )");
+}
+static void add_help_4(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--preserve-unreferenced-resources", "transformation", "use --remove-unreferenced-resources=no", R"(Synonym for --remove-unreferenced-resources=no. Use that instead.
 )");
 ap.addOptionHelp("--newline-before-endstream", "transformation", "force a newline before endstream", R"(For an extra newline before endstream. Using this option enables
@@ -290,9 +331,6 @@ Force the output PDF file's PDF version header to be the specified
 value, even if the file uses features that may not be available
 in that version.
 )");
-}
-static void add_help_4(QPDFArgParser& ap)
-{
 ap.addHelpTopic("page-ranges", "page range syntax", R"(A full description of the page range syntax, with examples, can be
 found in the manual. In summary, a range is a comma-separated list
 of groups. A group is a number or a range of numbers separated by a
@@ -360,6 +398,13 @@ File names are generated from the specified output file as follows:
 Page ranges are single page numbers for single-page groups or first-last
 for multi-page groups.
 )");
+ap.addOptionHelp("--split-pages-jobs", "modification", "write split pages using n threads", R"(--split-pages-jobs=n
+
+When used with --split-pages, write the output files using n
+worker threads. If n is 0, use one thread per available CPU.
+The output files are identical to those written without this
+option.
+)");
 ap.addOptionHelp("--overlay", "modification", "begin overlay options", R"(--overlay file [options] --
 
 Overlay pages from another PDF file on the output.
@@ -382,6 +427,9 @@ Push page annotations into the content streams. This may be
 necessary in some case when printing or splitting files.
 Parameters: "all", "print", "screen".
 )");
+}
+static void add_help_5(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--rotate", "modification", "rotate pages", R"(--rotate=[+|-]angle[:page-range]
 
 Rotate specified pages by multiples of 90 degrees specifying
@@ -403,6 +451,12 @@ options:
   --oi-min-width
   --oi-min-height
   --oi-min-area
+  --oi-max-memory
+  --optimize-images-jobs
+  --jpeg-quality
+  --jpeg-subsampling
+  --jpeg-optimize-huffman
+  --jpeg-progressive
   --keep-inline-images
 )");
 ap.addOptionHelp("--oi-min-width", "modification", "minimum width for --optimize-images", R"(--oi-min-width=width
@@ -417,13 +471,40 @@ ap.addOptionHelp("--oi-min-area", "modification", "minimum area for --optimize-i
 
 Don't optimize images whose area in pixels is below the specified value.
 )");
+ap.addOptionHelp("--oi-max-memory", "modification", "memory for images optimized by --optimize-images", R"(--oi-max-memory=bytes
+
+Keep at most this many bytes of optimized image data in
+memory. The rest is written to a temporary file.
+)");
+ap.addOptionHelp("--optimize-images-jobs", "modification", "optimize images using n threads", R"(--optimize-images-jobs=n
+
+When used with --optimize-images, compress images using n
+threads. If n is 0, use one thread per available CPU. The output
+is identical to that written without this option.
+)");
+ap.addOptionHelp("--jpeg-quality", "modification", "JPEG quality for --optimize-images", R"(--jpeg-quality=quality
+
+Compress images optimized by --optimize-images with the given
+JPEG quality, from 1 (smallest) to 100 (best). The default is
+75.
+)");
+ap.addOptionHelp("--jpeg-subsampling", "modification", "chroma subsampling for --optimize-images", R"(--jpeg-subsampling={444|422|420}
+
+Set the chroma subsampling for color images optimized by
+--optimize-images: 444 (none), 422 (half horizontal
+resolution), or 420 (half horizontal and vertical resolution,
+the default).
+)");
+ap.addOptionHelp("--jpeg-optimize-huffman", "modification", "optimize Huffman tables for --optimize-images", R"(Compute Huffman tables for each image optimized by
+--optimize-images. This makes images smaller and takes longer.
+)");
+ap.addOptionHelp("--jpeg-progressive", "modification", "write progressive JPEGs for --optimize-images", R"(Compress images optimized by --optimize-images as progressive
+JPEGs, which are usually smaller and take longer to write.
+)");
 ap.addOptionHelp("--keep-inline-images", "modification", "exclude inline images from optimization", R"(Prevent inline images from being considered by --optimize-images.
 )");
 ap.addOptionHelp("--remove-info", "modification", "remove file information", R"(Exclude file information (except modification date) from the output file.
 )");
-}
-static void add_help_5(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--remove-metadata", "modification", "remove metadata", R"(Exclude metadata from the output file.
 )");
 ap.addOptionHelp("--remove-page-labels", "modification", "remove explicit page numbers", R"(Exclude page labels (explicit page numbers) from the output file.
@@ -553,6 +634,9 @@ Values for modify-opt:
   annotate                 form + commenting and modifying forms
   all                      allow full document modification
 )");
+}
+static void add_help_6(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--user-password", "encryption", "specify user password", R"(--user-password=user-password
 
 Set the user password of the encrypted file.
@@ -645,9 +729,6 @@ reasons. Use 256-bit encryption instead.
 ap.addOptionHelp("--allow-insecure", "encryption", "allow empty owner passwords", R"(Allow creation of PDF files with empty owner passwords and
 non-empty user passwords when using 256-bit encryption.
 )");
-}
-static void add_help_6(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--force-V4", "encryption", "force V=4 in encryption dictionary", R"(This option is for testing and is never needed in practice since
 qpdf does this automatically when needed.
 )");
@@ -745,6 +826,9 @@ Specify the range of pages in the primary output to apply
 overlay/underlay to. See qpdf --help=page-ranges for help with
 the page range syntax.
 )");
+}
+static void add_help_7(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--from", "overlay-underlay", "source pages for underlay/overlay", R"(--from=[page-range]
 
 Specify pages from the overlay/underlay file that are applied to
@@ -830,9 +914,6 @@ ap.addOptionHelp("--description", "add-attachment", "set attachment's descriptio
 Supply descriptive text for the attachment, displayed by some
 PDF viewers.
 )");
-}
-static void add_help_7(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--replace", "add-attachment", "replace attachment with same key", R"(Indicate that any existing attachment with the same key should
 be replaced by the new attachment. Otherwise, qpdf gives an
 error if an attachment with that key is already present.
@@ -862,6 +943,9 @@ ap.addOptionHelp("--is-encrypted", "inspection", "silently test whether a file i
 This can be used with password-protected files even if you don't
 know the password.
 )");
+}
+static void add_help_8(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--requires-password", "inspection", "silently test a file's password", R"(Silently exit with a code indicating the file's password status:
 
 0: a password, other than as supplied, is required
@@ -922,9 +1006,6 @@ generation numbers for the image objects on each page.
 ap.addOptionHelp("--list-attachments", "inspection", "list embedded files", R"(Show the key and stream number for each embedded file. Combine
 with --verbose for more detailed information.
 )");
-}
-static void add_help_8(QPDFArgParser& ap)
-{
 ap.addOptionHelp("--show-attachment", "inspection", "export an embedded file", R"(--show-attachment=key
 
 Write the contents of the specified attachment to standard
@@ -953,6 +1034,9 @@ top-level keys will be included in the JSON output. Otherwise,
 all keys will be included. With --json-output, when not given,
 only the "qpdf" key will appear in the output.
 )");
+}
+static void add_help_9(QPDFArgParser& ap)
+{
 ap.addOptionHelp("--json-object", "json", "limit which objects are in JSON", R"(--json-object={trailer|obj[,gen]}
 
 This option is repeatable. If given, only specified objects will
@@ -1031,6 +1115,7 @@ static void add_help(QPDFArgParser& ap)
     add_help_6(ap);
     add_help_7(ap);
     add_help_8(ap);
+    add_help_9(ap);
 ap.addHelpFooter("For detailed help, visit the qpdf manual: https://qpdf.readthedocs.io\n");
 }
 
@@ -25,6 +25,7 @@ static char const* json_stream_data_choices[] = {"none", "inline", "file", 0};
 static char const* json_version_choices[] = {"1", "2", "latest", 0};
 static char const* enc_bits_choices[] = {"40", "128", "256", 0};
 static char const* print128_choices[] = {"full", "low", "none", 0};
+static char const* jpeg_subsampling_choices[] = {"444", "422", "420", 0};
 static char const* modify128_choices[] = {"all", "annotate", "form", "assembly", "none", 0};
 
 this->ap.selectHelpOptionTable();
@@ -51,11 +52,15 @@ this->ap.addBare("filtered-stream-data", [this](){c_main->filteredStreamData();}
 this->ap.addBare("flatten-rotation", [this](){c_main->flattenRotation();});
 this->ap.addBare("generate-appearances", [this](){c_main->generateAppearances();});
 this->ap.addBare("ignore-xref-streams", [this](){c_main->ignoreXrefStreams();});
+this->ap.addBare("incremental-update", [this](){c_main->incrementalUpdate();});
 this->ap.addBare("is-encrypted", [this](){c_main->isEncrypted();});
 this->ap.addBare("json-input", [this](){c_main->jsonInput();});
+this->ap.addBare("jpeg-optimize-huffman", [this](){c_main->jpegOptimizeHuffman();});
+this->ap.addBare("jpeg-progressive", [this](){c_main->jpegProgressive();});
 this->ap.addBare("keep-inline-images", [this](){c_main->keepInlineImages();});
 this->ap.addBare("linearize", [this](){c_main->linearize();});
 this->ap.addBare("list-attachments", [this](){c_main->listAttachments();});
+this->ap.addBare("mmap-input", [this](){c_main->mmapInput();});
 this->ap.addBare("newline-before-endstream", [this](){c_main->newlineBeforeEndstream();});
 this->ap.addBare("no-original-object-ids", [this](){c_main->noOriginalObjectIds();});
 this->ap.addBare("no-warn", [this](){c_main->noWarn();});
@@ -86,6 +91,7 @@ this->ap.addBare("show-pages", [this](){c_main->showPages();});
 this->ap.addBare("show-xref", [this](){c_main->showXref();});
 this->ap.addBare("static-aes-iv", [this](){c_main->staticAesIv();});
 this->ap.addBare("static-id", [this](){c_main->staticId();});
+this->ap.addBare("streaming-write", [this](){c_main->streamingWrite();});
 this->ap.addBare("suppress-password-recovery", [this](){c_main->suppressPasswordRecovery();});
 this->ap.addBare("suppress-recovery", [this](){c_main->suppressRecovery();});
 this->ap.addBare("test-json-schema", [this](){c_main->testJsonSchema();});
@@ -93,25 +99,33 @@ this->ap.addBare("underlay", b(&ArgParser::argUnderlay));
 this->ap.addBare("verbose", [this](){c_main->verbose();});
 this->ap.addBare("warning-exit-0", [this](){c_main->warningExit0();});
 this->ap.addBare("with-images", [this](){c_main->withImages();});
+this->ap.addRequiredParameter("compression-jobs", [this](std::string const& x){c_main->compressionJobs(x);}, "n");
 this->ap.addRequiredParameter("compression-level", [this](std::string const& x){c_main->compressionLevel(x);}, "level");
 this->ap.addRequiredParameter("copy-encryption", [this](std::string const& x){c_main->copyEncryption(x);}, "file");
 this->ap.addRequiredParameter("encryption-file-password", [this](std::string const& x){c_main->encryptionFilePassword(x);}, "password");
 this->ap.addRequiredParameter("force-version", [this](std::string const& x){c_main->forceVersion(x);}, "version");
 this->ap.addRequiredParameter("ii-min-bytes", [this](std::string const& x){c_main->iiMinBytes(x);}, "minimum");
 this->ap.addRequiredParameter("job-json-file", [this](std::string const& x){c_main->jobJsonFile(x);}, "file");
+this->ap.addRequiredParameter("jpeg-quality", [this](std::string const& x){c_main->jpegQuality(x);}, "quality");
 this->ap.addRequiredParameter("json-object", [this](std::string const& x){c_main->jsonObject(x);}, "trailer");
 this->ap.addRequiredParameter("keep-files-open-threshold", [this](std::string const& x){c_main->keepFilesOpenThreshold(x);}, "count");
 this->ap.addRequiredParameter("linearize-pass1", [this](std::string const& x){c_main->linearizePass1(x);}, "filename");
 this->ap.addRequiredParameter("min-version", [this](std::string const& x){c_main->minVersion(x);}, "version");
+this->ap.addRequiredParameter("object-stream-jobs", [this](std::string const& x){c_main->objectStreamJobs(x);}, "n");
+this->ap.addRequiredParameter("oi-max-memory", [this](std::string const& x){c_main->oiMaxMemory(x);}, "bytes");
 this->ap.addRequiredParameter("oi-min-area", [this](std::string const& x){c_main->oiMinArea(x);}, "minimum");
 this->ap.addRequiredParameter("oi-min-height", [this](std::string const& x){c_main->oiMinHeight(x);}, "minimum");
 this->ap.addRequiredParameter("oi-min-width", [this](std::string const& x){c_main->oiMinWidth(x);}, "minimum");
+this->ap.addRequiredParameter("optimize-images-jobs", [this](std::string const& x){c_main->optimizeImagesJobs(x);}, "n");
 this->ap.addRequiredParameter("password", [this](std::string const& x){c_main->password(x);}, "password");
+this->ap.addRequiredParameter("password-candidate-jobs", [this](std::string const& x){c_main->passwordCandidateJobs(x);}, "n");
+this->ap.addRequiredParameter("password-candidates", [this](std::string const& x){c_main->passwordCandidates(x);}, "file");
 this->ap.addRequiredParameter("password-file", [this](std::string const& x){c_main->passwordFile(x);}, "password");
 this->ap.addRequiredParameter("remove-attachment", [this](std::string const& x){c_main->removeAttachment(x);}, "attachment");
 this->ap.addRequiredParameter("rotate", [this](std::string const& x){c_main->rotate(x);}, "[+|-]angle");
 this->ap.addRequiredParameter("show-attachment", [this](std::string const& x){c_main->showAttachment(x);}, "attachment");
 this->ap.addRequiredParameter("show-object", [this](std::string const& x){c_main->showObject(x);}, "trailer");
+this->ap.addRequiredParameter("split-pages-jobs", [this](std::string const& x){c_main->splitPagesJobs(x);}, "n");
 this->ap.addRequiredParameter("json-stream-prefix", [this](std::string const& x){c_main->jsonStreamPrefix(x);}, "stream-file-prefix");
 this->ap.addRequiredParameter("update-from-json", [this](std::string const& x){c_main->updateFromJson(x);}, "qpdf-json file");
 this->ap.addOptionalParameter("collate", [this](std::string const& x){c_main->collate(x);});
@@ -121,6 +135,7 @@ this->ap.addChoices("decode-level", [this](std::string const& x){c_main->decodeL
 this->ap.addChoices("flatten-annotations", [this](std::string const& x){c_main->flattenAnnotations(x);}, true, flatten_choices);
 this->ap.addChoices("json-key", [this](std::string const& x){c_main->jsonKey(x);}, true, json_key_choices);
 this->ap.addChoices("json-stream-data", [this](std::string const& x){c_main->jsonStreamData(x);}, true, json_stream_data_choices);
+this->ap.addChoices("jpeg-subsampling", [this](std::string const& x){c_main->jpegSubsampling(x);}, true, jpeg_subsampling_choices);
 this->ap.addChoices("keep-files-open", [this](std::string const& x){c_main->keepFilesOpen(x);}, true, yn_choices);
 this->ap.addChoices("normalize-content", [this](std::string const& x){c_main->normalizeContent(x);}, true, yn_choices);
 this->ap.addChoices("object-streams", [this](std::string const& x){c_main->objectStreams(x);}, true, object_streams_choices);
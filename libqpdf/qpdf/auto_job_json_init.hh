@@ -18,6 +18,7 @@ static char const* json_stream_data_choices[] = {"none", "inline", "file", 0};
 static char const* json_version_choices[] = {"1", "2", "latest", 0};
 static char const* enc_bits_choices[] = {"40", "128", "256", 0};
 static char const* print128_choices[] = {"full", "low", "none", 0};
+static char const* jpeg_subsampling_choices[] = {"444", "422", "420", 0};
 static char const* modify128_choices[] = {"all", "annotate", "form", "assembly", "none", 0};
 
 pushKey("inputFile");
@@ -26,6 +27,12 @@ popHandler(); // key: inputFile
 pushKey("password");
 setupPassword();
 popHandler(); // key: password
+pushKey("passwordCandidateJobs");
+addParameter([this](std::string const& p) { c_main->passwordCandidateJobs(p); });
+popHandler(); // key: passwordCandidateJobs
+pushKey("passwordCandidates");
+addParameter([this](std::string const& p) { c_main->passwordCandidates(p); });
+popHandler(); // key: passwordCandidates
 pushKey("passwordFile");
 addParameter([this](std::string const& p) { c_main->passwordFile(p); });
 popHandler(); // key: passwordFile
@@ -92,6 +99,12 @@ popHandler(); // key: linearize
 pushKey("linearizePass1");
 addParameter([this](std::string const& p) { c_main->linearizePass1(p); });
 popHandler(); // key: linearizePass1
+pushKey("streamingWrite");
+addBare([this]() { c_main->streamingWrite(); });
+popHandler(); // key: streamingWrite
+pushKey("incrementalUpdate");
+addBare([this]() { c_main->incrementalUpdate(); });
+popHandler(); // key: incrementalUpdate
 pushKey("objectStreams");
 addChoices(object_streams_choices, true, [this](std::string const& p) { c_main->objectStreams(p); });
 popHandler(); // key: objectStreams
@@ -107,6 +120,9 @@ popHandler(); // key: progress
 pushKey("splitPages");
 addParameter([this](std::string const& p) { c_main->splitPages(p); });
 popHandler(); // key: splitPages
+pushKey("splitPagesJobs");
+addParameter([this](std::string const& p) { c_main->splitPagesJobs(p); });
+popHandler(); // key: splitPagesJobs
 pushKey("jsonOutput");
 addChoices(json_output_choices, false, [this](std::string const& p) { c_main->jsonOutput(p); });
 popHandler(); // key: jsonOutput
@@ -296,6 +312,12 @@ popHandler(); // key: testJsonSchema
 pushKey("ignoreXrefStreams");
 addBare([this]() { c_main->ignoreXrefStreams(); });
 popHandler(); // key: ignoreXrefStreams
+pushKey("mmapInput");
+addBare([this]() { c_main->mmapInput(); });
+popHandler(); // key: mmapInput
+pushKey("objectStreamJobs");
+addParameter([this](std::string const& p) { c_main->objectStreamJobs(p); });
+popHandler(); // key: objectStreamJobs
 pushKey("passwordIsHexKey");
 addBare([this]() { c_main->passwordIsHexKey(); });
 popHandler(); // key: passwordIsHexKey
@@ -311,6 +333,9 @@ popHandler(); // key: suppressRecovery
 pushKey("coalesceContents");
 addBare([this]() { c_main->coalesceContents(); });
 popHandler(); // key: coalesceContents
+pushKey("compressionJobs");
+addParameter([this](std::string const& p) { c_main->compressionJobs(p); });
+popHandler(); // key: compressionJobs
 pushKey("compressionLevel");
 addParameter([this](std::string const& p) { c_main->compressionLevel(p); });
 popHandler(); // key: compressionLevel
@@ -386,6 +411,9 @@ popHandler(); // key: generateAppearances
 pushKey("keepInlineImages");
 addBare([this]() { c_main->keepInlineImages(); });
 popHandler(); // key: keepInlineImages
+pushKey("oiMaxMemory");
+addParameter([this](std::string const& p) { c_main->oiMaxMemory(p); });
+popHandler(); // key: oiMaxMemory
 pushKey("oiMinArea");
 addParameter([this](std::string const& p) { c_main->oiMinArea(p); });
 popHandler(); // key: oiMinArea
@@ -398,6 +426,21 @@ popHandler(); // key: oiMinWidth
 pushKey("optimizeImages");
 addBare([this]() { c_main->optimizeImages(); });
 popHandler(); // key: optimizeImages
+pushKey("optimizeImagesJobs");
+addParameter([this](std::string const& p) { c_main->optimizeImagesJobs(p); });
+popHandler(); // key: optimizeImagesJobs
+pushKey("jpegQuality");
+addParameter([this](std::string const& p) { c_main->jpegQuality(p); });
+popHandler(); // key: jpegQuality
+pushKey("jpegSubsampling");
+addChoices(jpeg_subsampling_choices, true, [this](std::string const& p) { c_main->jpegSubsampling(p); });
+popHandler(); // key: jpegSubsampling
+pushKey("jpegOptimizeHuffman");
+addBare([this]() { c_main->jpegOptimizeHuffman(); });
+popHandler(); // key: jpegOptimizeHuffman
+pushKey("jpegProgressive");
+addBare([this]() { c_main->jpegProgressive(); });
+popHandler(); // key: jpegProgressive
 pushKey("pages");
 beginArray(bindJSON(&Handlers::beginPagesArray), bindBare(&Handlers::endPagesArray)); // .pages[]
 beginDict(bindJSON(&Handlers::beginPages), bindBare(&Handlers::endPages)); // .pages
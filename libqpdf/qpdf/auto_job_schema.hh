@@ -1,6 +1,8 @@
 static constexpr char const* JOB_SCHEMA_DATA = R"({
   "inputFile": "input filename",
   "password": "password for encrypted file",
+  "passwordCandidateJobs": "check password candidates using n threads",
+  "passwordCandidates": "try passwords from a file",
   "passwordFile": "read password from a file",
   "empty": "use empty file as input",
   "jsonInput": "input file is qpdf JSON",
@@ -23,11 +25,14 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "encryptionFilePassword": "supply password for copyEncryption",
   "linearize": "linearize (web-optimize) output",
   "linearizePass1": "save pass 1 of linearization",
+  "streamingWrite": "write output with bounded memory",
+  "incrementalUpdate": "append changes to the input file",
   "objectStreams": "control use of object streams",
   "minVersion": "set minimum PDF version",
   "forceVersion": "set output PDF version",
   "progress": "show progress when writing",
   "splitPages": "write pages to separate files",
+  "splitPagesJobs": "write split pages using n threads",
   "jsonOutput": "apply defaults for JSON serialization",
   "removeRestrictions": "remove security restrictions from input file",
   "encrypt": {
@@ -98,11 +103,14 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "verbose": "print additional information",
   "testJsonSchema": "test generated json against schema",
   "ignoreXrefStreams": "use xref tables rather than streams",
+  "mmapInput": "map the input file into memory",
+  "objectStreamJobs": "decode object streams using n threads",
   "passwordIsHexKey": "provide hex-encoded encryption key",
   "passwordMode": "tweak how qpdf encodes passwords",
   "suppressPasswordRecovery": "don't try different password encodings",
   "suppressRecovery": "suppress error recovery",
   "coalesceContents": "combine content streams",
+  "compressionJobs": "compress streams using n threads",
   "compressionLevel": "set compression level for flate",
   "externalizeInlineImages": "convert inline to regular images",
   "iiMinBytes": "set minimum size for externalizeInlineImages",
@@ -134,10 +142,16 @@ static constexpr char const* JOB_SCHEMA_DATA = R"({
   "flattenRotation": "remove rotation from page dictionary",
   "generateAppearances": "generate appearances for form fields",
   "keepInlineImages": "exclude inline images from optimization",
+  "oiMaxMemory": "memory for images optimized by optimizeImages",
   "oiMinArea": "minimum area for optimizeImages",
   "oiMinHeight": "minimum height for optimizeImages",
   "oiMinWidth": "minimum width for optimizeImages",
   "optimizeImages": "use efficient compression for images",
+  "optimizeImagesJobs": "optimize images using n threads",
+  "jpegQuality": "JPEG quality for optimizeImages",
+  "jpegSubsampling": "chroma subsampling for optimizeImages",
+  "jpegOptimizeHuffman": "optimize Huffman tables for optimizeImages",
+  "jpegProgressive": "write progressive JPEGs for optimizeImages",
   "pages": [
     {
       "file": "source for pages",
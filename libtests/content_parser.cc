@@ -0,0 +1,100 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/Pl_ContentParser.hh>
+#include <qpdf/QPDF.hh>
+#include <qpdf/QUtil.hh>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std::literals;
+
+namespace
+{
+    class Collector: public QPDFObjectHandle::ParserCallbacks
+    {
+      public:
+        ~Collector() override = default;
+        void
+        handleObject(QPDFObjectHandle obj, size_t offset, size_t length) override
+        {
+            std::string value = obj.isInlineImage()
+                ? "inline image " + QUtil::hex_encode(obj.getInlineImageValue())
+                : obj.unparse();
+            results.emplace_back(
+                std::to_string(offset) + " " + std::to_string(length) + ": " + value);
+        }
+        void
+        handleEOF() override
+        {
+        }
+
+        std::vector<std::string> results;
+    };
+} // namespace
+
+static std::vector<std::string>
+parse(QPDF& q, std::string const& content, size_t block_size, size_t chunk_size)
+{
+    Collector c;
+    Pl_ContentParser p("content parser", "test content", &c, &q, block_size);
+    for (size_t i = 0; i < content.size(); i += chunk_size) {
+        auto chunk = content.substr(i, chunk_size);
+        p.write(QUtil::unsigned_char_pointer(chunk), chunk.size());
+    }
+    p.finish();
+    p.rethrow();
+    for (auto const& w: q.getWarnings()) {
+        c.results.emplace_back(std::string("warning: ") + w.what());
+    }
+    return c.results;
+}
+
+static void
+test(QPDF& q, std::string const& label, std::string const& content)
+{
+    std::cout << "--- " << label << " ---" << std::endl;
+    auto expected = parse(q, content, content.size() + 1, content.size() + 1);
+    for (auto const& r: expected) {
+        std::cout << r << std::endl;
+    }
+    // Split the content at every possible place. Whatever the block size and however the data is
+    // written, the results must be the same as when it is parsed all at once.
+    for (size_t block_size: std::vector<size_t>{1, 2, 5, 16, 64}) {
+        for (size_t chunk_size: std::vector<size_t>{1, 2, 3, 7, 13, 100}) {
+            if (parse(q, content, block_size, chunk_size) != expected) {
+                std::cout << "mismatch with block size " << block_size << ", chunk size "
+                          << chunk_size << std::endl;
+            }
+        }
+    }
+}
+
+int
+main()
+{
+    QPDF q;
+    q.emptyPDF();
+    q.setSuppressWarnings(true);
+
+    test(
+        q,
+        "objects",
+        "q 1 0 0 1 72 720 cm % comment\n"
+        "/F1 12 Tf (string (with) \\) parens) Tj <48656c6c6f> Tj [(a) -20 (b)] TJ\n"
+        "/Span << /Key [1 2 3] /Sub << /A /B >> >> BDC EMC 3.14 -.5 true false null Q");
+    test(
+        q,
+        "inline images",
+        "BI /W 4 /H 1 /BPC 8 /CS /G ID \x00\x01\x02\x03 EI Q\n"
+        "BI /W 8 /H 1 /BPC 8 /CS /G ID ab\x00"
+        "EI\x01\x02 cdefg\nEI\n"
+        "BI /W 1 /H 1 /BPC 8 /CS /G ID\nz EI"s);
+    test(q, "bad tokens", "0 0 m <12/34> Tj [1 (x) <az>] ) }\n1 1 l");
+    test(q, "EOF in inline image", "q BI /W 1 /H 1 ID ");
+    test(q, "EOF in string", "q (unterminated");
+
+    std::cout << "content parser tests done" << std::endl;
+    return 0;
+}
@@ -6,18 +6,21 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <string>
 
 static void
 usage()
 {
-    std::cerr << "Usage: dct_compress infile outfile width height {rgb|cmyk|gray}" << std::endl;
+    std::cerr << "Usage: dct_compress infile outfile width height {rgb|cmyk|gray}"
+              << " [--quality=n] [--subsampling={444|422|420}] [--optimize-huffman]"
+              << " [--progressive]" << std::endl;
     exit(2);
 }
 
 int
 main(int argc, char* argv[])
 {
-    if (argc != 6) {
+    if (argc < 6) {
         usage();
     }
 
@@ -52,6 +55,24 @@ main(int argc, char* argv[])
     Pl_StdioFile out("stdout", outfile);
     unsigned char buf[100];
     Pl_DCT dct("dct", &out, width, height, components, cs);
+    for (int i = 6; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.substr(0, 10) == "--quality=") {
+            dct.setQuality(QUtil::string_to_int(arg.substr(10).c_str()));
+        } else if (arg == "--subsampling=444") {
+            dct.setSubsampling(Pl_DCT::s_444);
+        } else if (arg == "--subsampling=422") {
+            dct.setSubsampling(Pl_DCT::s_422);
+        } else if (arg == "--subsampling=420") {
+            dct.setSubsampling(Pl_DCT::s_420);
+        } else if (arg == "--optimize-huffman") {
+            dct.setOptimizeHuffman(true);
+        } else if (arg == "--progressive") {
+            dct.setProgressive(true);
+        } else {
+            usage();
+        }
+    }
     while (size_t len = fread(buf, 1, sizeof(buf), infile)) {
         dct.write(buf, len);
     }
@@ -1,7 +1,13 @@
 #include <qpdf/Buffer.hh>
 #include <qpdf/BufferInputSource.hh>
+#include <qpdf/FileInputSource.hh>
+#include <qpdf/InputSource_private.hh>
+#include <qpdf/MmapInputSource.hh>
 #include <qpdf/QPDFTokenizer.hh>
+#include <qpdf/QUtil.hh>
+#include <cstdio>
 #include <cstring>
+#include <functional>
 #include <iostream>
 
 static std::shared_ptr<Buffer>
@@ -50,8 +56,8 @@ check(char const* description, bool expected, bool actual)
     std::cout << description << ": " << ((actual == expected) ? "PASS" : "FAIL") << std::endl;
 }
 
-int
-main()
+static void
+run_tests(std::function<std::shared_ptr<InputSource>(Buffer&)> make_is)
 {
     std::shared_ptr<Buffer> b1 = get_buffer();
     unsigned char* b = b1->getBuffer();
@@ -60,8 +66,7 @@ main()
     // Overlap so that the first check() would advance past the start
     // of the next match
     memcpy(b + 2037, "potato potato salad ", 20);
-    auto is =
-        std::shared_ptr<InputSource>(new BufferInputSource("test buffer input source", b1.get()));
+    auto is = make_is(*b1);
     Finder f1(is, "salad");
     check("find potato salad", true, is->findFirst("potato", 0, 0, f1));
     check("barely find potato salad", true, is->findFirst("potato", 1100, 945, f1));
@@ -73,18 +78,93 @@ main()
 
     // Put one more right at EOF
     memcpy(b + b1->getSize() - 12, "potato salad", 12);
-    check("potato salad at EOF", true, is->findFirst("potato", 3000, 0, f1));
+    is = make_is(*b1);
+    Finder f2(is, "salad");
+    check("potato salad at EOF", true, is->findFirst("potato", 3000, 0, f2));
 
-    is->findFirst("potato", 0, 0, f1);
+    is->findFirst("potato", 0, 0, f2);
     check("findFirst found first", true, is->tell() == 2056);
-    check("findLast found potato salad", true, is->findLast("potato", 0, 0, f1));
+    check("findLast found potato salad", true, is->findLast("potato", 0, 0, f2));
     check("findLast found at EOF", true, is->tell() == 3172);
 
     // Make check() bump into EOF
     memcpy(b + b1->getSize() - 6, "potato", 6);
-    check("potato but not salad salad at EOF", false, is->findFirst("potato", 3000, 0, f1));
-    check("findLast found potato salad", true, is->findLast("potato", 0, 0, f1));
+    is = make_is(*b1);
+    Finder f3(is, "salad");
+    check("potato but not salad salad at EOF", false, is->findFirst("potato", 3000, 0, f3));
+    check("findLast found potato salad", true, is->findLast("potato", 0, 0, f3));
     check("findLast found first one", true, is->tell() == 2056);
+}
+
+static void
+test_buffered(char const* filename)
+{
+    // Read across the boundaries of the buffer's blocks.
+    auto const block_size = qpdf::is::Buffered::block_size;
+    std::string data;
+    for (size_t i = 0; i < 3 * block_size; ++i) {
+        data += static_cast<char>('a' + i % 26);
+    }
+    data[block_size - 1] = '\n';
+    data[block_size] = '\r';
+    auto f = QUtil::safe_fopen(filename, "wb");
+    fwrite(data.data(), 1, data.size(), f);
+    fclose(f);
+    auto size = static_cast<qpdf_offset_t>(data.size());
+    auto bs = static_cast<qpdf_offset_t>(block_size);
+
+    qpdf::is::Buffered is(std::make_shared<FileInputSource>(filename));
+    std::string s(100, '\0');
+    is.seek(bs - 50, SEEK_SET);
+    check("read across blocks", true, is.read(s.data(), 100) == 100);
+    check("data across blocks", true, s == data.substr(block_size - 50, 100));
+    check("position after read", true, is.tell() == bs + 50 && is.getLastOffset() == bs - 50);
+    is.seek(-60, SEEK_CUR);
+    check("find EOL", true, is.findAndSkipNextEOL() == bs - 1 && is.tell() == bs + 1);
+    is.seek(bs + 1, SEEK_SET);
+    check("find EOL across blocks", true, is.findAndSkipNextEOL() == size);
+    std::string big(2 * block_size, '\0');
+    is.seek(5, SEEK_SET);
+    check("large read", true, is.read(big.data(), big.size()) == big.size());
+    check("large read data", true, big == data.substr(5, 2 * block_size));
+    is.seek(size + 10, SEEK_SET);
+    check("read past EOF", true, is.read(s.data(), 1) == 0 && is.tell() == size);
+    is.seek(-3, SEEK_END);
+    check("seek from end", true, is.read(s.data(), 10) == 3);
+    check("data at end", true, s.substr(0, 3) == data.substr(data.size() - 3));
+}
+
+int
+main()
+{
+    std::cout << "BufferInputSource" << std::endl;
+    run_tests([](Buffer& buf) -> std::shared_ptr<InputSource> {
+        return std::make_shared<BufferInputSource>("test buffer input source", &buf);
+    });
+
+    // The memory-mapped input source searches its data in place rather than through findFirst's
+    // block buffer, so run the same checks against it.
+    std::cout << "MmapInputSource" << std::endl;
+    char const* filename = "input_source.tmp";
+    run_tests([filename](Buffer& buf) -> std::shared_ptr<InputSource> {
+        auto f = QUtil::safe_fopen(filename, "wb");
+        fwrite(buf.getBuffer(), 1, buf.getSize(), f);
+        fclose(f);
+        return std::make_shared<MmapInputSource>(filename);
+    });
+    QUtil::remove_file(filename);
+
+    // Files opened by QPDF are read through a block buffer that keeps track of the position
+    // itself.
+    std::cout << "Buffered FileInputSource" << std::endl;
+    run_tests([filename](Buffer& buf) -> std::shared_ptr<InputSource> {
+        auto f = QUtil::safe_fopen(filename, "wb");
+        fwrite(buf.getBuffer(), 1, buf.getSize(), f);
+        fclose(f);
+        return std::make_shared<qpdf::is::Buffered>(std::make_shared<FileInputSource>(filename));
+    });
+    test_buffered(filename);
+    QUtil::remove_file(filename);
 
     return 0;
 }
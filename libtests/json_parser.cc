@@ -0,0 +1,209 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/BufferInputSource.hh>
+#include <qpdf/JSON.hh>
+#include <qpdf/JSON_parser.hh>
+#include <qpdf/QIntC.hh>
+
+#include <iostream>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace qpdf;
+using namespace std::literals;
+
+namespace
+{
+    // Record the events reported by the parser. Offsets are reported relative to base so that the
+    // results for a document can be compared regardless of how much white space precedes it.
+    class Collector: public json::Handler
+    {
+      public:
+        Collector(qpdf_offset_t base) :
+            base(base)
+        {
+        }
+        ~Collector() override = default;
+
+        void
+        dictionaryStart() override
+        {
+            results.emplace_back("dictionary start");
+        }
+        void
+        arrayStart() override
+        {
+            results.emplace_back("array start");
+        }
+        void
+        containerEnd(json::Value const& value) override
+        {
+            results.emplace_back("container end: " + describe(value));
+        }
+        void
+        topLevelScalar() override
+        {
+            results.emplace_back("top-level scalar");
+        }
+        void
+        dictionaryItem(std::string_view key, json::Value const& value) override
+        {
+            results.emplace_back(
+                "dictionary item: " + JSON::makeString(std::string(key)).unparse() + " -> " +
+                describe(value));
+        }
+        void
+        arrayItem(json::Value const& value) override
+        {
+            results.emplace_back("array item: " + describe(value));
+        }
+        bool
+        skipStringValue(std::string_view key) override
+        {
+            return key == "skip";
+        }
+
+        std::vector<std::string> results;
+
+      private:
+        std::string
+        describe(json::Value const& value)
+        {
+            static char const* const types[] = {
+                "null", "bool", "number", "string", "dictionary", "array"};
+            std::string result = "[" + std::to_string(value.getStart() - base) + ", " +
+                std::to_string(value.getEnd() - base) + ") " + types[value.getType()];
+            std::string_view text;
+            bool b = false;
+            if (value.getString(text)) {
+                result += " " + JSON::makeString(std::string(text)).unparse();
+            } else if (value.getNumber(text)) {
+                result += " " + std::string(text);
+            } else if (value.getBool(b)) {
+                result += b ? " true" : " false";
+            }
+            return result;
+        }
+
+        qpdf_offset_t base;
+    };
+} // namespace
+
+// Parse content after pad characters of white space, which is long enough in some of the cases to
+// make the document cross the boundary between two reads from the input source.
+static std::vector<std::string>
+parse(std::string const& content, size_t pad)
+{
+    std::string white;
+    for (size_t i = 0; i < pad; ++i) {
+        white += " \n\t\r"[i % 4];
+    }
+    BufferInputSource is("json parser test", white + content);
+    Collector c(QIntC::to_offset(pad));
+    try {
+        json::parse(is, c);
+    } catch (std::runtime_error& e) {
+        // Make the offsets in error messages relative to the start of the content.
+        static std::regex const offset_re("offset (\\d+)");
+        std::string message = e.what();
+        std::string result;
+        std::smatch m;
+        while (std::regex_search(message, m, offset_re)) {
+            result += m.prefix().str() + "offset " +
+                std::to_string(std::stoull(m[1].str()) - pad);
+            message = m.suffix().str();
+        }
+        c.results.emplace_back("error: " + result + message);
+    }
+    return c.results;
+}
+
+static void
+test(std::string const& label, std::string const& content)
+{
+    std::cout << "--- " << label << " ---" << std::endl;
+    auto expected = parse(content, 0);
+    for (auto const& r: expected) {
+        std::cout << r << std::endl;
+    }
+    // Move the content relative to the blocks scanned at once and across the end of the parser's
+    // 16 KiB buffer. The results must not depend on where the content is.
+    std::vector<size_t> pads;
+    for (size_t i = 1; i <= 64; ++i) {
+        pads.push_back(i);
+    }
+    for (size_t i = 16384 - 2 * content.size() - 64; i <= 16384 + 64; ++i) {
+        pads.push_back(i);
+    }
+    for (auto pad: pads) {
+        if (parse(content, pad) != expected) {
+            std::cout << "mismatch with " << pad << " characters of white space" << std::endl;
+        }
+    }
+}
+
+int
+main()
+{
+    test("top-level string", R"("potato")");
+    test("top-level number", " -12.5e+3 ");
+    test("top-level keyword", "true");
+    test("junk after top-level scalar", R"("potato" 1)");
+    test("nested", R"({"a": [1, null, false, {"b": "c"}], "skip": "not collected", "d": {}})");
+    test("escapes", R"(["\"\\\/\b\f\n\r\t", "é🥔", "x\u0041y\ud83e\udd54"])");
+    test("long strings", "[\"" + std::string(100, 'a') + "\", \"" + std::string(40, 'b') + "\\n" +
+             std::string(40, 'c') + "\"]");
+    test("long white space", "[" + std::string(100, ' ') + "1,\n\t\r" + std::string(100, '\n') +
+             "2" + std::string(50, '\t') + "]");
+    test("bad escape", R"(["abc", "abcdef\q"])");
+    test("control character", "[\"abc\", \"abcdefgh\x01\"]");
+    test("bad escape in skipped string", R"({"skip": "abcdef\q"})");
+    test("control character in skipped string", "{\"skip\": \"abcdefgh\x01\"}");
+    test("tab in string", "[\"abc\", \"abcdefgh\t\"]");
+    test("tab in skipped string", "{\"skip\": \"abcdefgh\t\"}");
+    test("unterminated string", R"(["abcdefgh)");
+
+    // Put each kind of character that ends a run of plain string characters at every position
+    // relative to the start of the run, checking that the string is read correctly, or that the
+    // error is reported at the right offset.
+    for (std::string special: {"\\n"s, "\\u00e9"s, "\\\""s, "\x01"s, "\t"s, "\\q"s}) {
+        for (size_t before = 0; before <= 70; ++before) {
+            std::string key = before % 2 ? "skip" : "key";
+            std::string text = std::string(before, 'x') + special + std::string(40, 'y');
+            std::string content = "{\"" + key + "\": \"" + text + "\"}";
+            auto results = parse(content, 0);
+            std::string expected;
+            if (special == "\x01") {
+                expected = "error: JSON: control or null character at offset " +
+                    std::to_string(key.size() + 6 + before);
+            } else if (special == "\t") {
+                expected = "error: JSON: offset " + std::to_string(key.size() + 6 + before) +
+                    ": control character in string (missing \"?)";
+            } else if (special == "\\q") {
+                expected = "error: JSON: offset " + std::to_string(key.size() + 7 + before) +
+                    ": invalid character after backslash: q";
+            } else {
+                auto value = JSON::parse(content).getDictItem(key);
+                std::string s;
+                value.getString(s);
+                expected = "dictionary item: \"" + key + "\" -> [" +
+                    std::to_string(key.size() + 5) + ", " +
+                    std::to_string(content.size() - 1) + ") string " +
+                    (key == "skip" ? "\"\"" : JSON::makeString(s).unparse());
+                assert(s.size() == before + 40 + (special == "\\u00e9" ? 2 : 1));
+            }
+            if (results.size() < 2 || results.at(1) != expected) {
+                std::cout << "unexpected result for " << special << " after " << before
+                          << " characters" << std::endl;
+                for (auto const& r: results) {
+                    std::cout << "  " << r << std::endl;
+                }
+            }
+        }
+    }
+
+    std::cout << "json parser tests done" << std::endl;
+    return 0;
+}
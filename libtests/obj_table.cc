@@ -1,5 +1,9 @@
+#include <qpdf/assert_test.h>
+
 #include <qpdf/ObjTable.hh>
 
+#include <map>
+
 struct Test
 {
     Test() = default;
@@ -48,10 +52,94 @@ class Table: public ObjTable<Test>
     }
 };
 
+// Check that an ObjGenTable holds the same entries as the std::map it replaces.
+static void
+check(ObjGenTable<int> const& table, std::map<QPDFObjGen, int> const& map)
+{
+    assert(table.size() == map.size());
+    assert(table.empty() == map.empty());
+    auto it = map.begin();
+    for (auto const& [og, value]: table) {
+        assert(it != map.end() && it->first == og && it->second == value);
+        assert(table.get(og) && *table.get(og) == value);
+        ++it;
+    }
+    assert(it == map.end());
+    assert(table.last() == (map.empty() ? QPDFObjGen() : map.rbegin()->first));
+}
+
+static void
+test_obj_gen_table()
+{
+    ObjGenTable<int> table;
+    std::map<QPDFObjGen, int> map;
+    auto add = [&](int id, int gen, int value) {
+        auto [ref, inserted] = table.try_emplace(QPDFObjGen(id, gen), value);
+        auto result = map.try_emplace(QPDFObjGen(id, gen), value);
+        assert(inserted == result.second && ref == result.first->second);
+    };
+
+    check(table, map);
+    for (int i = 1; i < 3000; i += 3) {
+        add(i, 0, i);
+    }
+    // Later generations, ids far beyond the dense range, and repeated insertions.
+    for (int i: {4, 10, 2998}) {
+        add(i, 1, -i);
+        add(i, 2, -2 * i);
+    }
+    add(1000000, 0, 7);
+    add(500000, 3, 8);
+    add(4, 1, 99);
+    check(table, map);
+
+    // References remain valid while the table grows.
+    int& ref = table[QPDFObjGen(1, 0)];
+    for (int i = 3000; i < 10000; ++i) {
+        add(i, 0, i);
+    }
+    assert(&ref == table.get(QPDFObjGen(1, 0)));
+    check(table, map);
+
+    assert(table.has_later_generation(QPDFObjGen(4, 0)));
+    assert(table.has_later_generation(QPDFObjGen(4, 1)));
+    assert(!table.has_later_generation(QPDFObjGen(4, 2)));
+    assert(!table.has_later_generation(QPDFObjGen(7, 0)));
+    assert(table.count(QPDFObjGen(7, 0)) == 1);
+    assert(table.count(QPDFObjGen(7, 1)) == 0);
+    assert(table.count(QPDFObjGen(2, 0)) == 0);
+
+    for (auto og: {QPDFObjGen(4, 0), QPDFObjGen(4, 2), QPDFObjGen(1000000, 0), QPDFObjGen(2, 0)}) {
+        table.erase(og);
+        map.erase(og);
+    }
+    for (int i = 5000; i < 10000; ++i) {
+        table.erase(QPDFObjGen(i, 0));
+        map.erase(QPDFObjGen(i, 0));
+    }
+    check(table, map);
+    assert(table.last() == QPDFObjGen(500000, 3));
+
+    table[QPDFObjGen(4, 0)] = 12;
+    map[QPDFObjGen(4, 0)] = 12;
+    check(table, map);
+
+    table.clear();
+    map.clear();
+    check(table, map);
+    table.reserve_ids(100);
+    add(99, 0, 1);
+    add(5, 0, 2);
+    check(table, map);
+
+    std::cout << "object generation table tests done\n";
+}
+
 int
 main()
 {
     Table().test();
+    test_obj_gen_table();
 
     std::cout << "object table tests done\n";
     return 0;
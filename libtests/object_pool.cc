@@ -0,0 +1,61 @@
+#include <qpdf/assert_test.h>
+
+#include <qpdf/ObjectPool.hh>
+#include <qpdf/QPDF.hh>
+#include <qpdf/QPDFObjectHandle.hh>
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using Allocator = qpdf::ObjectPool::Allocator<std::pair<long, long>>;
+
+static void
+test_pool()
+{
+    std::vector<std::shared_ptr<std::pair<long, long>>> objects;
+    {
+        Allocator pool;
+        for (long i = 0; i < 10'000; ++i) {
+            objects.emplace_back(std::allocate_shared<std::pair<long, long>>(pool, i, -i));
+        }
+        // Freed blocks are reused.
+        auto* p = objects.back().get();
+        objects.pop_back();
+        objects.emplace_back(std::allocate_shared<std::pair<long, long>>(pool, 9'999, -9'999));
+        assert(objects.back().get() == p);
+
+        // Allocations of other sizes don't come from the pool.
+        std::vector<int, qpdf::ObjectPool::Allocator<int>> v(pool);
+        v.assign(1000, 1);
+        assert(v.size() == 1000 && v.back() == 1);
+    }
+    // The pool lives as long as the objects allocated from it.
+    for (long i = 0; i < 10'000; ++i) {
+        assert(objects.at(static_cast<size_t>(i))->first == i);
+        assert(objects.at(static_cast<size_t>(i))->second == -i);
+    }
+    std::cout << "pool tests done" << std::endl;
+}
+
+static void
+test_qpdf()
+{
+    // Objects parsed from a file remain usable after the QPDF is destroyed.
+    QPDFObjectHandle array;
+    {
+        auto pdf = QPDF::create();
+        pdf->emptyPDF();
+        array = QPDFObjectHandle::parse(pdf.get(), "[1 2.5 /Name (string) << /A [true] >>]", "");
+    }
+    assert(array.unparse() == "[ 1 2.5 /Name (string) << /A [ true ] >> ]");
+    std::cout << "QPDF tests done" << std::endl;
+}
+
+int
+main()
+{
+    test_pool();
+    test_qpdf();
+    return 0;
+}
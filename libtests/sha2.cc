@@ -1,7 +1,10 @@
 #include <qpdf/Pl_SHA2.hh>
+#include <qpdf/QPDFCryptoBulk.hh>
+#include <qpdf/QPDFCryptoProvider.hh>
 #include <qpdf/QUtil.hh>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 static void
 test(Pl_SHA2& sha2, char const* description, int bits, char const* input, std::string const& output)
@@ -19,6 +22,60 @@ test(Pl_SHA2& sha2, char const* description, int bits, char const* input, std::s
     }
 }
 
+static void
+test_batch(int bits)
+{
+    // Hash messages of every length up to a few blocks in batches of different sizes, and check
+    // that the digests are the same as when the messages are hashed one at a time.
+    auto crypto = QPDFCryptoProvider::getImpl();
+    auto bulk = dynamic_cast<QPDFCryptoBulk*>(crypto.get());
+    if (!bulk) {
+        std::cout << "batch " << bits << ": no QPDFCryptoBulk\n";
+        return;
+    }
+    size_t const n = 300;
+    size_t const digest_size = static_cast<size_t>(bits / 8);
+    std::vector<std::string> messages(n);
+    std::vector<std::string> expected(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            messages[i] += static_cast<char>((i * 7 + j * 13) & 0xff);
+        }
+        crypto->SHA2_init(bits);
+        crypto->SHA2_update(QUtil::unsigned_char_pointer(messages[i]), i);
+        crypto->SHA2_finalize();
+        expected[i] = crypto->SHA2_digest();
+    }
+    std::vector<unsigned char const*> in_data;
+    std::vector<size_t> lens;
+    std::vector<unsigned char*> out_data;
+    std::vector<std::string> digests(n, std::string(digest_size, '\0'));
+    for (size_t i = 0; i < n; ++i) {
+        // Mix long and short messages in each batch.
+        size_t k = (i % 2) ? n - 1 - i / 2 : i / 2;
+        in_data.push_back(QUtil::unsigned_char_pointer(messages[k]));
+        lens.push_back(messages[k].size());
+        out_data.push_back(QUtil::unsigned_char_pointer(digests[k]));
+    }
+    for (size_t start = 0, count = 1; start < n; start += count, count = count % 13 + 1) {
+        count = std::min(count, n - start);
+        bulk->SHA2_batch(
+            bits, count, in_data.data() + start, lens.data() + start, out_data.data() + start);
+    }
+    bool passed = true;
+    for (size_t i = 0; i < n; ++i) {
+        if (digests[i] != expected[i]) {
+            passed = false;
+            std::cout << "batch " << bits << ": length " << i << " failed\n"
+                      << "  expected: " << QUtil::hex_encode(expected[i]) << "\n"
+                      << "  actual:   " << QUtil::hex_encode(digests[i]) << "\n";
+        }
+    }
+    if (passed) {
+        std::cout << "batch " << bits << ": passed\n";
+    }
+}
+
 int
 main(int argc, char* argv[])
 {
@@ -89,6 +146,9 @@ main(int argc, char* argv[])
         million_a,
         "e718483d0ce769644e2e42c7bc15b4638e1f98b13b2044285632a803afa973eb"
         "de0ff244877ea60a4cb0432ce577c31beb009c5c2c49aa2e4eadb217ad8cc09b");
+    test_batch(256);
+    test_batch(384);
+    test_batch(512);
 
     return 0;
 }
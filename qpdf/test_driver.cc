@@ -3482,6 +3482,45 @@ test_99(QPDF& pdf, char const* arg2)
     }
 }
 
+static void
+test_100(QPDF& pdf, char const* arg2)
+{
+    // Look up pages by position without traversing the pages tree. This test uses
+    // page-tree-count.pdf, page-tree-bad-count.pdf, and direct-pages.pdf.
+    auto n = pdf.getPageCount();
+    std::cout << "count: " << n << std::endl;
+    for (size_t i = 0; i <= n; ++i) {
+        std::cout << i << ": " << pdf.getPage(i).unparse() << std::endl;
+    }
+    std::cout << "called getAllPages: " << pdf.everCalledGetAllPages() << std::endl;
+    auto const& pages = pdf.getAllPages();
+    assert(pdf.getPageCount() == pages.size());
+    for (size_t i = 0; i < pages.size(); ++i) {
+        assert(pdf.getPage(i).isSameObjectAs(pages.at(i)));
+    }
+    assert(pdf.getPage(pages.size()).isNull());
+}
+
+static void
+test_101(QPDF& pdf, char const* arg2)
+{
+    // Copy single pages to another file without enumerating the pages of this one. Inherited
+    // attributes are pushed down only to the copied pages. This test uses page-tree-count.pdf.
+    QPDF out;
+    out.emptyPDF();
+    QPDFPageDocumentHelper dh(out);
+    for (size_t i: std::vector<size_t>{3, 0, 4}) {
+        dh.addPage(pdf.getPage(i), false);
+    }
+    std::cout << "called getAllPages: " << pdf.everCalledGetAllPages() << std::endl;
+    std::cout << "source /MediaBox: "
+              << pdf.getRoot().getKey("/Pages").getKey("/MediaBox").unparse() << std::endl;
+    for (auto const& page: out.getAllPages()) {
+        std::cout << "copied /MediaBox: " << page.getKey("/MediaBox").unparse() << " "
+                  << page.getKey("/MediaBox").unparseResolved() << std::endl;
+    }
+}
+
 void
 runtest(int n, char const* filename1, char const* arg2)
 {
@@ -3579,7 +3618,8 @@ runtest(int n, char const* filename1, char const* arg2)
         {78, test_78}, {79, test_79}, {80, test_80}, {81, test_81}, {82, test_82}, {83, test_83},
         {84, test_84}, {85, test_85}, {86, test_86}, {87, test_87}, {88, test_88}, {89, test_89},
         {90, test_90}, {91, test_91}, {92, test_92}, {93, test_93}, {94, test_94}, {95, test_95},
-        {96, test_96}, {97, test_97}, {98, test_98}, {99, test_99}};
+        {96, test_96}, {97, test_97}, {98, test_98}, {99, test_99}, {100, test_100},
+        {101, test_101}};
 
     auto fn = test_functions.find(n);
     if (fn == test_functions.end()) {